@@ -74,7 +74,8 @@ enum sampling_method {
     SAMPLE_FAST, 
     SAMPLE_INTERPOLATE,
     SAMPLE_RESAMPLE, 
-    SAMPLE_RESAMPLE_FASTMEM 
+    SAMPLE_RESAMPLE_FASTMEM,
+    SAMPLE_RESAMPLE_TWOPASS
 };
 
 } // namespace reSID
@@ -156,12 +156,13 @@ class CustomAudioOptionView : public AudioOptionView
 		sidEngineItem
 	};
 
-	TextMenuItem reSidSamplingItem[4]
+	TextMenuItem reSidSamplingItem[5]
 	{
 		{"Fast", [](){ setReSidSampling_(SID_RESID_SAMPLING_FAST); }},
 		{"Interpolation", [](){ setReSidSampling_(SID_RESID_SAMPLING_INTERPOLATION); }},
 		{"Resampling", [](){ setReSidSampling_(SID_RESID_SAMPLING_RESAMPLING); }},
 		{"Fast Resampling", [](){ setReSidSampling_(SID_RESID_SAMPLING_FAST_RESAMPLING); }},
+		{"Two-Pass Resampling", [](){ setReSidSampling_(SID_RESID_SAMPLING_TWOPASS_RESAMPLING); }},
 	};
 
 	MultiChoiceMenuItem reSidSampling
@@ -215,6 +216,26 @@ class CustomSystemOptionView : public SystemOptionView
 			setAutostartTDE(optionAutostartTDE);		}
 	};
 
+	BoolMenuItem mediaAccessWarp
+	{
+		"Fast-forward Disk/Tape Access",
+		(bool)optionMediaAccessWarp,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionMediaAccessWarp = item.flipBoolValue(*this);
+		}
+	};
+
+	BoolMenuItem pipelinedEmulation
+	{
+		"Pipelined Emulation",
+		(bool)optionPipelinedEmulation,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionPipelinedEmulation = item.flipBoolValue(*this);
+		}
+	};
+
 	TextHeadingMenuItem defaultsHeading
 	{
 		"Default Boot Options"
@@ -449,6 +470,8 @@ public:
 		item.emplace_back(&systemFilePath);
 		item.emplace_back(&autostartTDE);
 		item.emplace_back(&autostartWarp);
+		item.emplace_back(&mediaAccessWarp);
+		item.emplace_back(&pipelinedEmulation);
 		item.emplace_back(&defaultsHeading);
 		item.emplace_back(&trueDriveEmu);
 		item.emplace_back(&virtualDeviceTraps);
@@ -17,6 +17,7 @@
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuInput.hh>
 #include <emuframework/EmuAppInlines.hh>
+#include <emuframework/AVCapture.hh>
 #include <imagine/thread/Thread.hh>
 #include <imagine/thread/Semaphore.hh>
 #include <imagine/gui/AlertView.hh>
@@ -72,6 +73,8 @@ extern "C"
 const char *EmuSystem::creditsViewStr = CREDITS_INFO_STRING "(c) 2013-2018\nRobert Broglia\nwww.explusalpha.com\n\nPortions (c) the\nVice Team\nwww.viceteam.org";
 IG::Semaphore execSem{0}, execDoneSem{0};
 bool runningFrame = false, doAudio = false;
+bool c64FrameInFlight = false;
+static bool inFlightFrameRendered = false;
 static bool c64IsInit = false, c64FailedInit = false;
 bool autostartOnLoad = true;
 FS::PathString firmwareBasePath{};
@@ -397,9 +400,74 @@ static bool hasC64Extension(const char *name)
 EmuSystem::NameFilterFunc EmuSystem::defaultFsFilter = hasC64Extension;
 EmuSystem::NameFilterFunc EmuSystem::defaultBenchmarkFsFilter = hasC64Extension;
 
+// drive LEDs and datasette motor, updated from the C64 thread
+static uint driveLedMask = 0;
+static bool tapeMotorOn = false;
+
+CLINK LVISIBLE void ui_display_drive_led(int drive_number, unsigned int pwm1, unsigned int led_pwm2);
+void ui_display_drive_led(int drive_number, unsigned int pwm1, unsigned int led_pwm2)
+{
+	if(pwm1 || led_pwm2)
+		driveLedMask |= IG::bit(drive_number);
+	else
+		driveLedMask &= ~IG::bit(drive_number);
+}
+
+CLINK LVISIBLE void ui_display_tape_motor_status(int motor);
+void ui_display_tape_motor_status(int motor)
+{
+	tapeMotorOn = motor;
+}
+
+static void updateMediaBusy()
+{
+	// let the app fast-forward while VICE warps (autostart) or media is accessed
+	EmuSystem::setMediaBusy(*plugin.warp_mode_enabled ||
+		(optionMediaAccessWarp && (driveLedMask || tapeMotorOn)));
+}
+
+static void execC64Frame()
+{
+	// signal C64 thread to execute one frame and wait for it to finish
+	execSem.notify();
+	execDoneSem.wait();
+}
+
+void syncC64Thread()
+{
+	if(!c64FrameInFlight)
+		return;
+	// wait for the pipelined frame to finish so the C64 state can be accessed
+	execDoneSem.wait();
+	c64FrameInFlight = false;
+	runningFrame = 0;
+	applyLatchedInput();
+}
+
+void EmuSystem::onPause()
+{
+	syncC64Thread();
+}
+
+static void skipC64Frames(uint frames)
+{
+	if(!EmuSystem::gameIsRunning())
+		return;
+	syncC64Thread();
+	runningFrame = 1;
+	doAudio = false;
+	setCanvasSkipFrame(true);
+	iterateTimes(frames, i)
+	{
+		execC64Frame();
+	}
+	runningFrame = 0;
+}
+
 void EmuSystem::reset(ResetMode mode)
 {
 	assert(gameIsRunning());
+	syncC64Thread();
 	plugin.machine_trigger_reset(mode == RESET_HARD ? MACHINE_RESET_MODE_HARD : MACHINE_RESET_MODE_SOFT);
 }
 
@@ -437,26 +505,28 @@ static void saveSnapshotTrap(WORD, void *data)
 
 EmuSystem::Error EmuSystem::saveState(const char *path)
 {
+	syncC64Thread();
 	SnapshotTrapData data;
 	data.pathStr = path;
 	plugin.interrupt_maincpu_trigger_trap(saveSnapshotTrap, (void*)&data);
-	skipFrames(1); // execute cpu trap
+	skipC64Frames(1); // execute cpu trap
 	return data.hasError ? makeFileWriteError() : Error{};
 }
 
 EmuSystem::Error EmuSystem::loadState(const char *path)
 {
+	syncC64Thread();
 	plugin.resources_set_int("WarpMode", 0);
 	SnapshotTrapData data;
 	data.pathStr = path;
-	skipFrames(1); // run extra frame in case C64 was just started
+	skipC64Frames(1); // run extra frame in case C64 was just started
 	plugin.interrupt_maincpu_trigger_trap(loadSnapshotTrap, (void*)&data);
-	skipFrames(1); // execute cpu trap, snapshot load may cause reboot from a C64 model change
+	skipC64Frames(1); // execute cpu trap, snapshot load may cause reboot from a C64 model change
 	if(data.hasError)
 		return makeFileReadError();
 	// reload snapshot in case last load caused a reboot
 	plugin.interrupt_maincpu_trigger_trap(loadSnapshotTrap, (void*)&data);
-	skipFrames(1); // execute cpu trap
+	skipC64Frames(1); // execute cpu trap
 	bool hasError = data.hasError;
 	isPal = sysIsPal();
 	return hasError ? makeFileReadError() : Error{};
@@ -474,6 +544,7 @@ bool EmuSystem::vidSysIsPAL() { return isPal; }
 
 void EmuSystem::closeSystem()
 {
+	syncC64Thread();
 	if(!gameIsRunning())
 	{
 		return;
@@ -530,6 +601,7 @@ bool EmuApp::willCreateSystem(ViewAttachParams attach, Input::Event e)
 
 EmuSystem::Error EmuSystem::loadGame(IO &, OnLoadProgressDelegate)
 {
+	syncC64Thread();
 	if(!initC64())
 	{
 		return c64FirmwareError();
@@ -569,40 +641,84 @@ EmuSystem::Error EmuSystem::loadGame(IO &, OnLoadProgressDelegate)
 	return {};
 }
 
-static void execC64Frame()
+static void runPipelinedFrame(EmuVideo *video, bool renderAudio)
 {
-	// signal C64 thread to execute one frame and wait for it to finish
+	// frame N, started by the previous call, is presented while frame N+1 runs
+	bool hasFrame = c64FrameInFlight && (!video || inFlightFrameRendered);
+	syncC64Thread();
+	runningFrame = 1;
+	if(!hasFrame)
+	{
+		// pipeline is empty or its frame was skipped, run this frame directly
+		doAudio = renderAudio;
+		setCanvasSkipFrame(!video);
+		execC64Frame();
+		if(video)
+		{
+			video->setFormat(canvasSrcPix);
+			video->writeFrame(canvasSrcPix);
+		}
+	}
+	// the C64 thread latches into the other buffer, so this one stays valid while it runs
+	auto pix = hasFrame && video ? latchedCanvasFrame() : IG::Pixmap{};
+	doAudio = renderAudio;
+	// rendering the next frame is predicted from this one, a wrong guess only
+	// costs the overlap on the next call
+	inFlightFrameRendered = video;
+	setCanvasSkipFrame(!video);
+	// sampled while the C64 thread is idle, it writes these during the frame
+	updateMediaBusy();
+	c64FrameInFlight = true;
 	execSem.notify();
-	execDoneSem.wait();
+	if(pix.w())
+	{
+		video->setFormat(pix);
+		video->writeFrame(pix);
+	}
 }
 
 void EmuSystem::runFrame(EmuVideo *video, bool renderAudio)
 {
-	runningFrame = 1;
-	// "Warp" mode frame
-	if(unlikely(*plugin.warp_mode_enabled && video))
+	// captured frames must write their audio before runFrame() returns, while
+	// the capture's sound-only setting still applies to them
+	if(optionPipelinedEmulation && !avCapture.isActive())
 	{
-		setCanvasSkipFrame(true);
-		iterateTimes(8, i)
-		{
-			execC64Frame();
-		}
+		runPipelinedFrame(video, renderAudio);
+		return;
 	}
-
-	// Normal frame
+	syncC64Thread();
+	runningFrame = 1;
+	// Normal frame, rendered straight into the locked texture when possible
 	doAudio = renderAudio;
 	setCanvasSkipFrame(!video);
-	execC64Frame();
+	EmuVideoImage img{};
 	if(video)
 	{
 		video->setFormat(canvasSrcPix);
-		video->writeFrame(canvasSrcPix);
+		img = video->startFrame();
+		setCanvasTarget(img.pixmap());
+	}
+	execC64Frame();
+	if(video)
+	{
+		if(endCanvasTarget())
+		{
+			img.endFrame();
+		}
+		else
+		{
+			img.cancelFrame();
+			video->setFormat(canvasSrcPix);
+			video->writeFrame(canvasSrcPix);
+		}
 	}
 	runningFrame = 0;
+	updateMediaBusy();
 }
 
 void EmuSystem::configAudioRate(double frameTime, int rate)
 {
+	syncC64Thread();
 	logMsg("set audio rate %d", rate);
 	pcmFormat.rate = rate;
 	int mixRate = std::round(rate * (systemFrameRate * frameTime));
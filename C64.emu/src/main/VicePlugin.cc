@@ -313,6 +313,14 @@ void VicePlugin::video_canvas_render(struct video_canvas_s *canvas, BYTE *trg,
 	}
 }
 
+void VicePlugin::video_canvas_refresh_all(struct video_canvas_s *canvas)
+{
+	if(video_canvas_refresh_all_)
+	{
+		video_canvas_refresh_all_(canvas);
+	}
+}
+
 void VicePlugin::video_render_setphysicalcolor(video_render_config_t *config,
 	int index, DWORD color, int depth)
 {
@@ -427,6 +435,7 @@ VicePlugin commonVicePlugin(void *lib, ViceSystem system)
 	plugin.drive_check_type_ = (typeof plugin.drive_check_type_)dlsym(lib, "drive_check_type");
 	plugin.sound_register_device_ = (typeof plugin.sound_register_device_)dlsym(lib, "sound_register_device");
 	plugin.video_canvas_render_ = (typeof plugin.video_canvas_render_)dlsym(lib, "video_canvas_render");
+	plugin.video_canvas_refresh_all_ = (typeof plugin.video_canvas_refresh_all_)dlsym(lib, "video_canvas_refresh_all");
 	plugin.video_render_setphysicalcolor_ = (typeof plugin.video_render_setphysicalcolor_)dlsym(lib, "video_render_setphysicalcolor");
 	plugin.video_render_setrawrgb_ = (typeof plugin.video_render_setrawrgb_)dlsym(lib, "video_render_setrawrgb");
 	plugin.video_render_initraw_ = (typeof plugin.video_render_initraw_)dlsym(lib, "video_render_initraw");
@@ -80,6 +80,7 @@ struct VicePlugin
 	void (*video_canvas_render_)(struct video_canvas_s *canvas, BYTE *trg,
 		int width, int height, int xs, int ys,
 		int xt, int yt, int pitcht, int depth){};
+	void (*video_canvas_refresh_all_)(struct video_canvas_s *canvas){};
 	void (*video_render_setphysicalcolor_)(video_render_config_t *config,
 		int index, DWORD color, int depth){};
 	void (*video_render_setrawrgb_)(unsigned int index, DWORD r, DWORD g, DWORD b){};
@@ -120,6 +121,7 @@ struct VicePlugin
 	void video_canvas_render(struct video_canvas_s *canvas, BYTE *trg,
 		int width, int height, int xs, int ys,
 		int xt, int yt, int pitcht, int depth);
+	void video_canvas_refresh_all(struct video_canvas_s *canvas);
 	void video_render_setphysicalcolor(video_render_config_t *config,
 		int index, DWORD color, int depth);
 	void video_render_setrawrgb(unsigned int index, DWORD r, DWORD g, DWORD b);
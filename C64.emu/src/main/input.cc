@@ -16,6 +16,7 @@
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuInput.hh>
 #include "internal.hh"
+#include <array>
 
 enum
 {
@@ -136,6 +137,16 @@ const uint EmuSystem::maxPlayers = 2;
 
 static bool shiftLock = false, ctrlLock = false;
 
+struct LatchedInputAction
+{
+	uint state;
+	uint emuKey;
+};
+
+// input that arrives while a pipelined frame runs is applied at the next frame boundary
+static std::array<LatchedInputAction, 32> latchedInput{};
+static uint latchedInputs = 0;
+
 static const uint JOYPAD_FIRE = 0x10,
 	JOYPAD_E = 0x08,
 	JOYPAD_W = 0x04,
@@ -437,8 +448,28 @@ static void setC64KBKey(int key, bool pushed)
 	}
 }
 
+void applyLatchedInput()
+{
+	uint inputs = latchedInputs;
+	latchedInputs = 0;
+	iterateTimes(inputs, i)
+	{
+		EmuSystem::handleInputAction(latchedInput[i].state, latchedInput[i].emuKey);
+	}
+}
+
 void EmuSystem::handleInputAction(uint state, uint emuKey)
 {
+	if(c64FrameInFlight)
+	{
+		if(latchedInputs < latchedInput.size())
+		{
+			latchedInput[latchedInputs++] = {state, emuKey};
+			return;
+		}
+		// queue is full, wait for the frame and apply everything now
+		syncC64Thread();
+	}
 	auto &joystick_value = *plugin.joystick_value;
 	if(emuKey & 0xFF0000) // Joystick
 	{
@@ -511,6 +542,8 @@ void EmuSystem::handleInputAction(uint state, uint emuKey)
 
 void EmuSystem::clearInputBuffers(EmuInputView &)
 {
+	syncC64Thread();
+	latchedInputs = 0;
 	auto &keyarr = *plugin.keyarr;
 	auto &rev_keyarr = *plugin.rev_keyarr;
 	auto &joystick_value = *plugin.joystick_value;
@@ -11,6 +11,7 @@ extern ViceSystem currSystem;
 extern FS::PathString sysFilePath[Config::envIsLinux ? 5 : 3];
 extern bool doAudio;
 extern bool runningFrame;
+extern bool c64FrameInFlight;
 extern bool autostartOnLoad;
 static constexpr auto pixFmt = IG::PIXEL_FMT_RGB565;
 extern IG::Semaphore execSem, execDoneSem;
@@ -37,6 +38,8 @@ extern Byte1Option optionBorderMode;
 extern Byte1Option optionSidEngine;
 extern Byte1Option optionReSidSampling;
 extern Byte1Option optionSwapJoystickPorts;
+extern Byte1Option optionPipelinedEmulation;
+extern Byte1Option optionMediaAccessWarp;
 extern PathOption optionFirmwarePath;
 
 int intResource(const char *name);
@@ -68,4 +71,9 @@ bool hasC64TapeExtension(const char *name);
 bool hasC64CartExtension(const char *name);
 int optionModel(ViceSystem system);
 void resetCanvasSourcePixmap(struct video_canvas_s *c);
+IG::Pixmap latchedCanvasFrame();
+void setCanvasTarget(IG::Pixmap pix);
+bool endCanvasTarget();
+void syncC64Thread();
+void applyLatchedInput();
 
@@ -41,7 +41,8 @@ enum
 	CFGKEY_CBM2_MODEL = 268, CFGKEY_CBM5x0_MODEL = 269,
 	CFGKEY_PET_MODEL = 270, CFGKEY_PLUS4_MODEL = 271,
 	CFGKEY_VIC20_MODEL = 272, CFGKEY_VICE_SYSTEM = 273,
-	CFGKEY_VIRTUAL_DEVICE_TRAPS = 274, CFGKEY_RESID_SAMPLING = 275
+	CFGKEY_VIRTUAL_DEVICE_TRAPS = 274, CFGKEY_RESID_SAMPLING = 275,
+	CFGKEY_PIPELINED_EMULATION = 276, CFGKEY_MEDIA_ACCESS_WARP = 277
 };
 
 const char *EmuSystem::configFilename = "C64Emu.config";
@@ -80,8 +81,10 @@ Byte1Option optionBorderMode(CFGKEY_BORDER_MODE, VICII_NORMAL_BORDERS);
 Byte1Option optionSidEngine(CFGKEY_SID_ENGINE, SID_ENGINE_RESID, false,
 	optionIsValidWithMax<1, uint8>);
 Byte1Option optionReSidSampling(CFGKEY_RESID_SAMPLING, SID_RESID_SAMPLING_INTERPOLATION, false,
-	optionIsValidWithMax<3, uint8>);
+	optionIsValidWithMax<4, uint8>);
 Byte1Option optionSwapJoystickPorts(CFGKEY_SWAP_JOYSTICK_PORTS, 0);
+Byte1Option optionPipelinedEmulation(CFGKEY_PIPELINED_EMULATION, 0);
+Byte1Option optionMediaAccessWarp(CFGKEY_MEDIA_ACCESS_WARP, 0);
 PathOption optionFirmwarePath(CFGKEY_SYSTEM_FILE_PATH, firmwareBasePath, "");
 
 EmuSystem::Error EmuSystem::onOptionsLoaded()
@@ -120,6 +123,8 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 		bcase CFGKEY_SWAP_JOYSTICK_PORTS: optionSwapJoystickPorts.readFromIO(io, readSize);
 		bcase CFGKEY_SYSTEM_FILE_PATH: optionFirmwarePath.readFromIO(io, readSize);
 		bcase CFGKEY_RESID_SAMPLING: optionReSidSampling.readFromIO(io, readSize);
+		bcase CFGKEY_PIPELINED_EMULATION: optionPipelinedEmulation.readFromIO(io, readSize);
+		bcase CFGKEY_MEDIA_ACCESS_WARP: optionMediaAccessWarp.readFromIO(io, readSize);
 	}
 	return 1;
 }
@@ -144,6 +149,8 @@ void EmuSystem::writeConfig(IO &io)
 	optionCropNormalBorders.writeWithKeyIfNotDefault(io);
 	optionSidEngine.writeWithKeyIfNotDefault(io);
 	optionReSidSampling.writeWithKeyIfNotDefault(io);
+	optionPipelinedEmulation.writeWithKeyIfNotDefault(io);
+	optionMediaAccessWarp.writeWithKeyIfNotDefault(io);
 	optionSwapJoystickPorts.writeWithKeyIfNotDefault(io);
 	optionFirmwarePath.writeToIO(io);
 }
@@ -167,7 +167,6 @@ int ui_extend_image_dialog(void)
 	return 0;
 }
 
-void ui_display_drive_led(int drive_number, unsigned int pwm1, unsigned int led_pwm2) {}
 void ui_display_drive_track(unsigned int drive_number, unsigned int drive_base, unsigned int half_track_number) {}
 void ui_display_joyport(BYTE *joyport) {}
 void ui_enable_drive_status(ui_drive_enable_t state, int *drive_led_color) {}
@@ -359,7 +358,6 @@ void fullscreen_capability(cap_fullscreen_t *cap_fullscreen) {}
 void ui_display_tape_current_image(const char *image) {}
 void ui_display_drive_current_image(unsigned int drive_number, const char *image) {}
 void ui_display_tape_control_status(int control) {}
-void ui_display_tape_motor_status(int motor) {}
 void ui_display_tape_counter(int counter) {}
 void ui_display_recording(int recording_status) {}
 void ui_display_playback(int playback_status, char *version) {}
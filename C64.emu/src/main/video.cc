@@ -33,12 +33,69 @@ extern "C"
 struct video_canvas_s *activeCanvas{};
 IG::Pixmap canvasSrcPix{};
 double systemFrameRate = 60.0;
+// finished frames from the pipelined C64 thread, one is presented while the other is written
+static IG::MemPixmap latchedFramePix[2];
+static uint latchedFrameIdx = 0;
+// locked texture memory the next frame is rendered into directly,
+// cropped like canvasSrcPix with its origin at canvasSrcOffset
+static IG::Pixmap canvasTargetPix{};
+static IG::WP canvasSrcOffset{};
+static bool renderingCanvasTarget = false;
+static bool canvasTargetWritten = false;
+// set when updates were skipped while rendering to the target
+static bool canvasPixmapStale = false;
 
 void setCanvasSkipFrame(bool on)
 {
 	activeCanvas->skipFrame = on;
 }
 
+static void latchCanvasFrame()
+{
+	uint idx = latchedFrameIdx ^ 1;
+	auto &pix = latchedFramePix[idx];
+	if(pix != canvasSrcPix)
+	{
+		pix = IG::MemPixmap{{canvasSrcPix.size(), canvasSrcPix.format()}};
+	}
+	pix.write(canvasSrcPix);
+	latchedFrameIdx = idx;
+}
+
+IG::Pixmap latchedCanvasFrame()
+{
+	return latchedFramePix[latchedFrameIdx];
+}
+
+void setCanvasTarget(IG::Pixmap pix)
+{
+	canvasTargetPix = pix;
+	canvasTargetWritten = false;
+}
+
+bool endCanvasTarget()
+{
+	canvasTargetPix = {};
+	return canvasTargetWritten;
+}
+
+static void renderCanvasTarget(struct video_canvas_s *c)
+{
+	if(canvasTargetPix.size() != canvasSrcPix.size())
+	{
+		// canvas was resized during the frame, caller copies canvasSrcPix instead
+		logMsg("canvas target size mismatch");
+		canvasTargetPix = {};
+		canvasPixmapStale = false;
+		plugin.video_canvas_refresh_all(c);
+		return;
+	}
+	renderingCanvasTarget = true;
+	plugin.video_canvas_refresh_all(c);
+	renderingCanvasTarget = false;
+	canvasTargetWritten = true;
+}
+
 CLINK LVISIBLE int vsync_do_vsync2(struct video_canvas_s *c, int been_skipped);
 int vsync_do_vsync2(struct video_canvas_s *c, int been_skipped)
 {
@@ -46,6 +103,23 @@ int vsync_do_vsync2(struct video_canvas_s *c, int been_skipped)
 	if(likely(runningFrame))
 	{
 		//logMsg("vsync_do_vsync signaling main thread");
+		if(!c->skipFrame)
+		{
+			if(canvasTargetPix)
+			{
+				renderCanvasTarget(c);
+			}
+			else if(canvasPixmapStale)
+			{
+				canvasPixmapStale = false;
+				plugin.video_canvas_refresh_all(c);
+			}
+		}
+		if(c64FrameInFlight && !c->skipFrame)
+		{
+			// main thread may be presenting the previous frame while the canvas is drawn again
+			latchCanvasFrame();
+		}
 		execDoneSem.notify();
 		execSem.wait();
 	}
@@ -99,6 +173,39 @@ void video_canvas_refresh(struct video_canvas_s *c, unsigned int xs, unsigned in
 	yi *= c->videoconfig->scaley;
 	h *= c->videoconfig->scaley;
 
+	if(canvasTargetPix && !renderingCanvasTarget)
+	{
+		// whole frame goes to the target at vsync
+		canvasPixmapStale = true;
+		return;
+	}
+
+	if(renderingCanvasTarget)
+	{
+		// clip to the cropped area and render straight into the texture
+		int x = (int)xi - canvasSrcOffset.x;
+		int y = (int)yi - canvasSrcOffset.y;
+		int width = w, height = h;
+		if(x < 0)
+		{
+			xs += -x / c->videoconfig->scalex;
+			width += x;
+			x = 0;
+		}
+		if(y < 0)
+		{
+			ys += -y / c->videoconfig->scaley;
+			height += y;
+			y = 0;
+		}
+		width = std::min(width, (int)canvasTargetPix.w() - x);
+		height = std::min(height, (int)canvasTargetPix.h() - y);
+		if(width <= 0 || height <= 0)
+			return;
+		plugin.video_canvas_render(c, (BYTE*)canvasTargetPix.pixel({}), width, height, xs, ys, x, y, canvasTargetPix.pitchBytes(), pixFmt.bitsPerPixel());
+		return;
+	}
+
 	w = std::min(w, c->pixmap->w());
 	h = std::min(h, c->pixmap->h());
 
@@ -126,10 +233,12 @@ void resetCanvasSourcePixmap(struct video_canvas_s *c)
 		int width = 320+(xBorderSize*2 - startX*2);
 		int widthPadding = startX*2;
 		canvasSrcPix = c->pixmap->subPixmap({startX, startY}, {width, height});
+		canvasSrcOffset = {startX, startY};
 	}
 	else
 	{
 		canvasSrcPix = *c->pixmap;
+		canvasSrcOffset = {};
 	}
 }
 
@@ -27,6 +27,18 @@
 #include "sid.h"
 #include <math.h>
 
+#ifndef RESID_NO_SIMD
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+#endif
+
 #ifndef round
 #define round(x) (x>=0.0?floor(x+0.5):ceil(x-0.5))
 #endif
@@ -34,6 +46,65 @@
 namespace reSID
 {
 
+// ----------------------------------------------------------------------------
+// Dot product of two 16 bit sample/FIR vectors, the inner loop of all
+// resampling. The products are summed in 32 bit wraparound arithmetic in
+// every path, so the vector kernels give the same result as the plain loop.
+// ----------------------------------------------------------------------------
+static inline int convolve(const short* a, const short* b, int n)
+{
+  int v = 0;
+  int j = 0;
+
+#ifndef RESID_NO_SIMD
+#if defined(__AVX2__)
+  if (n >= 16) {
+    __m256i acc = _mm256_setzero_si256();
+    for (; j + 16 <= n; j += 16) {
+      __m256i x = _mm256_loadu_si256((const __m256i*)(a + j));
+      __m256i y = _mm256_loadu_si256((const __m256i*)(b + j));
+      acc = _mm256_add_epi32(acc, _mm256_madd_epi16(x, y));
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                                _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+    v = _mm_cvtsi128_si32(sum);
+  }
+#elif defined(__SSE2__)
+  if (n >= 8) {
+    __m128i acc = _mm_setzero_si128();
+    for (; j + 8 <= n; j += 8) {
+      __m128i x = _mm_loadu_si128((const __m128i*)(a + j));
+      __m128i y = _mm_loadu_si128((const __m128i*)(b + j));
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(x, y));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+    v = _mm_cvtsi128_si32(acc);
+  }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  if (n >= 8) {
+    int32x4_t acc = vdupq_n_s32(0);
+    for (; j + 8 <= n; j += 8) {
+      int16x8_t x = vld1q_s16(a + j);
+      int16x8_t y = vld1q_s16(b + j);
+      acc = vmlal_s16(acc, vget_low_s16(x), vget_low_s16(y));
+      acc = vmlal_s16(acc, vget_high_s16(x), vget_high_s16(y));
+    }
+    int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    v = vget_lane_s32(vpadd_s32(sum, sum), 0);
+  }
+#endif
+#endif
+
+  for (; j < n; j++) {
+    v += a[j]*b[j];
+  }
+
+  return v;
+}
+
 // ----------------------------------------------------------------------------
 // Constructor.
 // ----------------------------------------------------------------------------
@@ -42,6 +113,11 @@ SID::SID()
   // Initialize pointers.
   sample = 0;
   fir = 0;
+  for (int i = 0; i < 2; i++) {
+    resample_stage[i].sample = 0;
+    resample_stage[i].fir = 0;
+  }
+  intermediate_frequency = 0;
   fir_N = 0;
   fir_RES = 0;
   fir_beta = 0;
@@ -70,6 +146,7 @@ SID::~SID()
 {
   delete[] sample;
   delete[] fir;
+  free_twopass();
 }
 
 
@@ -513,7 +590,8 @@ bool SID::set_sampling_parameters(double clock_freq, sampling_method method,
                         double sample_freq, double pass_freq, double filter_scale)
 {
   // Check resampling constraints.
-  if (method == SAMPLE_RESAMPLE || method == SAMPLE_RESAMPLE_FASTMEM)
+  if (method == SAMPLE_RESAMPLE || method == SAMPLE_RESAMPLE_FASTMEM ||
+      method == SAMPLE_RESAMPLE_TWOPASS)
   {
     // Check whether the sample ring buffer would overfill.
     if (FIR_N*clock_freq/sample_freq >= RINGSIZE) {
@@ -550,6 +628,19 @@ bool SID::set_sampling_parameters(double clock_freq, sampling_method method,
   sample_prev = 0;
   sample_now = 0;
 
+  if (method == SAMPLE_RESAMPLE_TWOPASS) {
+    if (set_twopass_parameters(clock_freq, sample_freq, pass_freq, filter_scale)) {
+      delete[] sample;
+      delete[] fir;
+      sample = 0;
+      fir = 0;
+      return true;
+    }
+    // No usable intermediate frequency, resample in a single pass.
+    sampling = method = SAMPLE_RESAMPLE;
+  }
+  free_twopass();
+
   // FIR initialization is only necessary for resampling.
   if (method != SAMPLE_RESAMPLE && method != SAMPLE_RESAMPLE_FASTMEM)
   {
@@ -576,14 +667,11 @@ bool SID::set_sampling_parameters(double clock_freq, sampling_method method,
   const double A = -20*log10(1.0/(1 << 16));
   // A fraction of the bandwidth is allocated to the transition band,
   double dw = (1 - 2*pass_freq/sample_freq)*pi*2;
-  // The cutoff frequency is midway through the transition band (nyquist)
-  double wc = pi;
 
   // For calculation of beta and N see the reference for the kaiserord
   // function in the MATLAB Signal Processing Toolbox:
   // http://www.mathworks.com/access/helpdesk/help/toolbox/signal/kaiserord.html
   const double beta = 0.1102*(A - 8.7);
-  const double I0beta = I0(beta);
 
   // The filter order will maximally be 124 with the current constraints.
   // N >= (96.33 - 7.95)/(2.285*0.1*pi) -> N >= 123
@@ -623,7 +711,25 @@ bool SID::set_sampling_parameters(double clock_freq, sampling_method method,
   delete[] fir;
   fir = new short[fir_N*fir_RES];
 
-  // Calculate fir_RES FIR tables for linear interpolation.
+  fill_fir(fir, fir_N, fir_RES, beta, f_cycles_per_sample, f_samples_per_cycle,
+           filter_scale);
+
+  return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// Calculate fir_RES FIR tables for linear interpolation.
+// ----------------------------------------------------------------------------
+void SID::fill_fir(short* fir, int fir_N, int fir_RES, double beta,
+                   double f_cycles_per_sample, double f_samples_per_cycle,
+                   double filter_scale)
+{
+  const double pi = 3.1415926535897932385;
+  // The cutoff frequency is midway through the transition band (nyquist)
+  const double wc = pi;
+  const double I0beta = I0(beta);
+
   for (int i = 0; i < fir_RES; i++) {
     int fir_offset = i*fir_N + fir_N/2;
     double j_offset = double(i)/fir_RES;
@@ -639,11 +745,111 @@ bool SID::set_sampling_parameters(double clock_freq, sampling_method method,
       fir[fir_offset + j] = (short)round(val);
     }
   }
+}
+
+
+// ----------------------------------------------------------------------------
+// Set up one step of two-pass resampling from in_freq to out_freq, keeping
+// everything up to pass_freq. Returns false if the filter would overfill
+// the ring buffer.
+// ----------------------------------------------------------------------------
+bool SID::set_resample_stage(ResampleStage& stage, double in_freq,
+                             double out_freq, double pass_freq,
+                             double filter_scale)
+{
+  const double pi = 3.1415926535897932385;
+
+  // Same Kaiser design as in set_sampling_parameters(), the transition
+  // band runs from pass_freq to out_freq - pass_freq.
+  const double A = -20*log10(1.0/(1 << 16));
+  double dw = (1 - 2*pass_freq/out_freq)*pi*2;
+  const double beta = 0.1102*(A - 8.7);
+
+  int N = int((A - 7.95)/(2.285*dw) + 0.5);
+  N += N & 1;
+
+  double f_samples_per_cycle = out_freq/in_freq;
+  double f_cycles_per_sample = in_freq/out_freq;
+
+  int fir_N = int(N*f_cycles_per_sample) + 1;
+  fir_N |= 1;
+  if (fir_N >= RINGSIZE) {
+    return false;
+  }
+
+  int n = (int)ceil(log(FIR_RES/f_cycles_per_sample)/log(2.0f));
+  if (n < 0) {
+    n = 0;
+  }
+
+  stage.cycles_per_sample =
+    cycle_count(f_cycles_per_sample*(1 << FIXP_SHIFT) + 0.5);
+  stage.sample_offset = stage.cycles_per_sample;
+  stage.sample_index = 0;
+
+  if (!stage.sample) {
+    stage.sample = new short[RINGSIZE*2];
+  }
+  for (int j = 0; j < RINGSIZE*2; j++) {
+    stage.sample[j] = 0;
+  }
+
+  if (!stage.fir || stage.fir_N != fir_N || stage.fir_RES != 1 << n) {
+    delete[] stage.fir;
+    stage.fir = new short[fir_N << n];
+  }
+  stage.fir_N = fir_N;
+  stage.fir_RES = 1 << n;
+  fill_fir(stage.fir, stage.fir_N, stage.fir_RES, beta, f_cycles_per_sample,
+           f_samples_per_cycle, filter_scale);
+
+  return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// Two-pass resampling goes through the intermediate frequency found by
+// Laurent Ganier (see clock_resample()). The first filter only has to
+// remove what would alias into the passband at the intermediate frequency,
+// so its transition band is wide and its order low, while the second, sharp
+// filter runs at a fraction of the clock frequency. Together they need
+// around a quarter of the multiplications of single-pass resampling at
+// 44.1kHz.
+// ----------------------------------------------------------------------------
+bool SID::set_twopass_parameters(double clock_freq, double sample_freq,
+                                 double pass_freq, double filter_scale)
+{
+  double f = 2*pass_freq +
+    sqrt(2*pass_freq*clock_freq*(sample_freq - 2*pass_freq)/sample_freq);
+
+  if (!(f > sample_freq && f < clock_freq/2)) {
+    return false;
+  }
 
+  // The filter scaling guards against clipping from the ringing of the
+  // sharp filter, so only the second pass is scaled.
+  if (!set_resample_stage(resample_stage[0], clock_freq, f, pass_freq, 1.0) ||
+      !set_resample_stage(resample_stage[1], f, sample_freq, pass_freq, filter_scale)) {
+    free_twopass();
+    return false;
+  }
+
+  intermediate_frequency = f;
   return true;
 }
 
 
+void SID::free_twopass()
+{
+  for (int i = 0; i < 2; i++) {
+    delete[] resample_stage[i].sample;
+    delete[] resample_stage[i].fir;
+    resample_stage[i].sample = 0;
+    resample_stage[i].fir = 0;
+  }
+}
+
+
 // ----------------------------------------------------------------------------
 // Adjustment of SID sampling frequency.
 //
@@ -660,6 +866,10 @@ void SID::adjust_sampling_frequency(double sample_freq)
 {
   cycles_per_sample =
     cycle_count(clock_frequency/sample_freq*(1 << FIXP_SHIFT) + 0.5);
+  if (sampling == SAMPLE_RESAMPLE_TWOPASS) {
+    resample_stage[1].cycles_per_sample =
+      cycle_count(intermediate_frequency/sample_freq*(1 << FIXP_SHIFT) + 0.5);
+  }
 }
 
 
@@ -756,6 +966,72 @@ void SID::clock(cycle_count delta_t)
 }
 
 
+// ----------------------------------------------------------------------------
+// Filtered output sample at the given 16.16 fixed point offset past
+// sample_start, from the two nearest FIR tables.
+// ----------------------------------------------------------------------------
+inline int SID::fir_sample(const short* sample_start, const short* fir,
+                           int fir_N, int fir_RES, cycle_count sample_offset)
+{
+  int fir_offset = sample_offset*fir_RES >> FIXP_SHIFT;
+  int fir_offset_rmd = sample_offset*fir_RES & FIXP_MASK;
+  const short* fir_start = fir + fir_offset*fir_N;
+
+  // Convolution with filter impulse response.
+  int v1 = convolve(sample_start, fir_start, fir_N);
+
+  // Use next FIR table, wrap around to first FIR table using
+  // next sample.
+  if (unlikely(++fir_offset == fir_RES)) {
+    fir_offset = 0;
+    ++sample_start;
+  }
+  fir_start = fir + fir_offset*fir_N;
+
+  // Convolution with filter impulse response.
+  int v2 = convolve(sample_start, fir_start, fir_N);
+
+  // Linear interpolation.
+  // fir_offset_rmd is equal for all samples, it can thus be factorized out:
+  // sum(v1 + rmd*(v2 - v1)) = sum(v1) + rmd*(sum(v2) - sum(v1))
+  int v = v1 + (fir_offset_rmd*(v2 - v1) >> FIXP_SHIFT);
+
+  v >>= FIR_SHIFT;
+
+  // Saturated arithmetics to guard against 16 bit sample overflow.
+  const int half = 1 << 15;
+  if (v >= half) {
+    v = half - 1;
+  }
+  else if (v < -half) {
+    v = -half;
+  }
+
+  return v;
+}
+
+
+// ----------------------------------------------------------------------------
+// Feed one input sample to a two-pass resampling stage. Returns true with
+// the filtered sample in out whenever an output sample is due.
+// ----------------------------------------------------------------------------
+inline bool SID::resample_stage_input(ResampleStage& stage, short in, short& out)
+{
+  stage.sample[stage.sample_index] = stage.sample[stage.sample_index + RINGSIZE] = in;
+  ++stage.sample_index &= RINGMASK;
+
+  stage.sample_offset -= 1 << FIXP_SHIFT;
+  if (stage.sample_offset >= 1 << FIXP_SHIFT) {
+    return false;
+  }
+
+  out = fir_sample(stage.sample + stage.sample_index - stage.fir_N - 1 + RINGSIZE,
+                   stage.fir, stage.fir_N, stage.fir_RES, stage.sample_offset);
+  stage.sample_offset += stage.cycles_per_sample;
+  return true;
+}
+
+
 // ----------------------------------------------------------------------------
 // SID clocking with audio sampling.
 // Fixed point arithmetics are used.
@@ -782,6 +1058,8 @@ int SID::clock(cycle_count& delta_t, short* buf, int n, int interleave)
     return clock_resample(delta_t, buf, n, interleave);
   case SAMPLE_RESAMPLE_FASTMEM:
     return clock_resample_fastmem(delta_t, buf, n, interleave);
+  case SAMPLE_RESAMPLE_TWOPASS:
+    return clock_resample_twopass(delta_t, buf, n, interleave);
   }
 }
 
@@ -921,48 +1199,31 @@ int SID::clock_resample(cycle_count& delta_t, short* buf, int n, int interleave)
 
     sample_offset = next_sample_offset & FIXP_MASK;
 
-    int fir_offset = sample_offset*fir_RES >> FIXP_SHIFT;
-    int fir_offset_rmd = sample_offset*fir_RES & FIXP_MASK;
-    short* fir_start = fir + fir_offset*fir_N;
-    short* sample_start = sample + sample_index - fir_N - 1 + RINGSIZE;
+    buf[s*interleave] = fir_sample(sample + sample_index - fir_N - 1 + RINGSIZE,
+                                   fir, fir_N, fir_RES, sample_offset);
+  }
 
-    // Convolution with filter impulse response.
-    int v1 = 0;
-    for (int j = 0; j < fir_N; j++) {
-      v1 += sample_start[j]*fir_start[j];
-    }
+  return s;
+}
 
-    // Use next FIR table, wrap around to first FIR table using
-    // next sample.
-    if (unlikely(++fir_offset == fir_RES)) {
-      fir_offset = 0;
-      ++sample_start;
-    }
-    fir_start = fir + fir_offset*fir_N;
 
-    // Convolution with filter impulse response.
-    int v2 = 0;
-    for (int k = 0; k < fir_N; k++) {
-      v2 += sample_start[k]*fir_start[k];
-    }
-
-    // Linear interpolation.
-    // fir_offset_rmd is equal for all samples, it can thus be factorized out:
-    // sum(v1 + rmd*(v2 - v1)) = sum(v1) + rmd*(sum(v2) - sum(v1))
-    int v = v1 + (fir_offset_rmd*(v2 - v1) >> FIXP_SHIFT);
+// ----------------------------------------------------------------------------
+// SID clocking with audio sampling - cycle based with two-pass audio
+// resampling, see set_twopass_parameters().
+// ----------------------------------------------------------------------------
+int SID::clock_resample_twopass(cycle_count& delta_t, short* buf, int n, int interleave)
+{
+  int s = 0;
 
-    v >>= FIR_SHIFT;
+  while (s < n && delta_t > 0) {
+    clock();
+    delta_t--;
 
-    // Saturated arithmetics to guard against 16 bit sample overflow.
-    const int half = 1 << 15;
-    if (v >= half) {
-      v = half - 1;
-    }
-    else if (v < -half) {
-      v = -half;
+    short v;
+    if (resample_stage_input(resample_stage[0], output(), v) &&
+        resample_stage_input(resample_stage[1], v, v)) {
+      buf[s++*interleave] = v;
     }
-
-    buf[s*interleave] = v;
   }
 
   return s;
@@ -1002,10 +1263,7 @@ int SID::clock_resample_fastmem(cycle_count& delta_t, short* buf, int n, int int
     short* sample_start = sample + sample_index - fir_N + RINGSIZE;
 
     // Convolution with filter impulse response.
-    int v = 0;
-    for (int j = 0; j < fir_N; j++) {
-      v += sample_start[j]*fir_start[j];
-    }
+    int v = convolve(sample_start, fir_start, fir_N);
 
     v >>= FIR_SHIFT;
 
@@ -102,6 +102,7 @@ public:
   int clock_interpolate(cycle_count& delta_t, short* buf, int n, int interleave);
   int clock_resample(cycle_count& delta_t, short* buf, int n, int interleave);
   int clock_resample_fastmem(cycle_count& delta_t, short* buf, int n, int interleave);
+  int clock_resample_twopass(cycle_count& delta_t, short* buf, int n, int interleave);
   void write();
 
   chip_model sid_model;
@@ -161,6 +162,35 @@ public:
 
   // FIR_RES filter tables (FIR_N*FIR_RES).
   short* fir;
+
+  // One step of two-pass resampling, with its own ring buffer and FIR
+  // tables. sample_offset is the 16.16 fixed point distance from the newest
+  // input sample to the next output sample.
+  struct ResampleStage
+  {
+    cycle_count cycles_per_sample;
+    cycle_count sample_offset;
+    int sample_index;
+    int fir_N;
+    int fir_RES;
+    short* sample;
+    short* fir;
+  };
+
+  // Clock frequency -> intermediate frequency -> sample frequency.
+  ResampleStage resample_stage[2];
+  double intermediate_frequency;
+
+  static void fill_fir(short* fir, int fir_N, int fir_RES, double beta,
+  double f_cycles_per_sample, double f_samples_per_cycle, double filter_scale);
+  static int fir_sample(const short* sample_start, const short* fir,
+  int fir_N, int fir_RES, cycle_count sample_offset);
+  bool set_resample_stage(ResampleStage& stage, double in_freq,
+  double out_freq, double pass_freq, double filter_scale);
+  bool set_twopass_parameters(double clock_freq, double sample_freq,
+  double pass_freq, double filter_scale);
+  void free_twopass();
+  static bool resample_stage_input(ResampleStage& stage, short in, short& out);
 };
 
 
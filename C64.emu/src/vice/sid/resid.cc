@@ -211,6 +211,10 @@ static int resid_init(sound_t *psid, int speed, int cycles_per_sec, int factor)
         method = SAMPLE_RESAMPLE_FASTMEM;
         sprintf(method_text, "fast resampling, pass to %dHz", (int)passband);
         break;
+      case 4:
+        method = SAMPLE_RESAMPLE_TWOPASS;
+        sprintf(method_text, "two-pass resampling, pass to %dHz", (int)passband);
+        break;
     }
 
     if (!psid->sid->set_sampling_parameters(cycles_per_sec, method,
@@ -32,6 +32,7 @@
 #define SID_RESID_SAMPLING_INTERPOLATION        1
 #define SID_RESID_SAMPLING_RESAMPLING           2
 #define SID_RESID_SAMPLING_FAST_RESAMPLING      3
+#define SID_RESID_SAMPLING_TWOPASS_RESAMPLING   4
 
 extern int sid_resources_init(void);
 extern int sid_common_resources_init(void);
@@ -241,7 +241,7 @@ extern VICE_API void video_canvas_resize(struct video_canvas_s *canvas, char res
 extern VICE_API void video_canvas_render(struct video_canvas_s *canvas, BYTE *trg,
                                 int width, int height, int xs, int ys,
                                 int xt, int yt, int pitcht, int depth);
-extern void video_canvas_refresh_all(struct video_canvas_s *canvas);
+extern VICE_API void video_canvas_refresh_all(struct video_canvas_s *canvas);
 extern char video_canvas_can_resize(struct video_canvas_s *canvas);
 extern void video_viewport_get(struct video_canvas_s *canvas,
                                struct viewport_s **viewport,
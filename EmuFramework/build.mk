@@ -30,7 +30,15 @@ EmuVideoLayer.cc \
 Cheats.cc \
 Recent.cc \
 EmuLoadProgressView.cc \
-RecentGameView.cc
+RecentGameView.cc \
+VideoFilterThreads.cc \
+BackupMemFlusher.cc \
+AVCapture.cc \
+InputMovie.cc \
+Netplay.cc \
+NetplayView.cc \
+MemSearch.cc \
+MemSearchView.cc
 
 ifeq ($(emuFramework_onScreenControls), 1)
  SRC += TouchConfigView.cc \
@@ -57,6 +65,7 @@ pkgVersion := $(metadata_version)
 LDLIBS := -l$(libName) $(LDLIBS)
 
 include $(IMAGINE_PATH)/make/package/imagine.mk
+include $(IMAGINE_PATH)/make/package/zlib.mk
 include $(IMAGINE_PATH)/make/package/stdc++.mk
 
 include $(IMAGINE_PATH)/make/imagineStaticLibTarget.mk
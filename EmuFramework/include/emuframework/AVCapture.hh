@@ -0,0 +1,120 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/pixmap/Pixmap.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/thread/Thread.hh>
+#include <imagine/thread/Semaphore.hh>
+#include <imagine/time/Time.hh>
+#include <imagine/util/audio/PcmFormat.hh>
+#include <atomic>
+#include <memory>
+
+// Records every emulated video frame and sound block without blocking emulation.
+// Frames and samples go through single-producer/single-consumer queues to a
+// writer thread, anything that doesn't fit is counted as dropped and replaced
+// by a repeated frame or silence so the streams stay in sync.
+//
+// Video is written to a .emucap file, all values little-endian:
+//   header: "EMUCAP01", uint64 frame time in nanoseconds
+//   records: uint8 type, uint32 payload size, payload
+//     'F' format: uint32 width, height, bytes per pixel, IG::PixelFormatID,
+//         the next frame is a key frame
+//     'K' key frame: zlib compressed rows, packed without padding
+//     'D' delta frame: zlib compressed XOR against the previous frame
+//     'R' repeat: previous frame is shown again (duplicate or dropped frame)
+// Audio is written unmodified to a .wav file.
+class AVCapture
+{
+public:
+	static constexpr uint VIDEO_SLOTS = 16;
+	static constexpr uint KEY_FRAME_INTERVAL = 300;
+
+	struct Stats
+	{
+		uint frames = 0;
+		uint duplicateFrames = 0;
+		uint droppedFrames = 0;
+		uint droppedAudioFrames = 0;
+		uint64 videoBytes = 0;
+		uint64 audioBytes = 0;
+		IG::Time writerTime{};
+	};
+
+	AVCapture() {}
+	bool start(FS::PathString basePath, double frameTime, Audio::PcmFormat pcmFormat);
+	// waits for queued data to be written and closes the files
+	Stats stop();
+	bool isActive() const { return active; }
+	// called from the emulation thread, never blocks
+	void writeFrame(const IG::Pixmap &pix);
+	void writeSound(const void *samples, uint bytes);
+
+private:
+	struct VideoSlot
+	{
+		std::unique_ptr<char[]> data{};
+		size_t capacity = 0;
+		IG::PixmapDesc desc{};
+		uint dropsBefore = 0;
+	};
+	struct AudioBlockHeader
+	{
+		uint32 silenceBefore;
+		uint32 size;
+	};
+
+	bool active = false;
+	std::atomic_bool stopRequested{false};
+	IG::Semaphore writerWake{0};
+	IG::Semaphore writerDone{0};
+	FileIO videoFile{};
+	FileIO audioFile{};
+	Audio::PcmFormat pcmFormat{};
+	Stats stats{};
+
+	// video queue, head is only written by the emulation thread, tail by the writer
+	VideoSlot slot[VIDEO_SLOTS]{};
+	std::atomic_uint videoHead{0}, videoTail{0};
+	uint pendingDrops = 0;
+
+	// audio byte ring of AudioBlockHeader + samples, same ownership rules as the video queue
+	std::unique_ptr<char[]> audioBuff{};
+	uint audioBuffSize = 0;
+	std::atomic_uint audioHead{0}, audioTail{0};
+	uint pendingSilence = 0;
+
+	// writer thread state
+	IG::PixmapDesc prevDesc{};
+	std::unique_ptr<char[]> prevFrame{}, deltaFrame{}, compressed{};
+	size_t compressedCapacity = 0;
+	uint framesSinceKey = 0;
+
+	void runWriter();
+	bool drainVideo();
+	bool drainAudio();
+	void encodeFrame(const VideoSlot &s);
+	void writeRecord(uint8 type, const void *data, uint32 size);
+	bool writeCompressedRecord(uint8 type, const void *data, size_t size);
+	void writeSilence(uint bytes);
+	void audioRingRead(uint pos, void *dest, uint bytes);
+	void audioRingWrite(uint pos, const void *src, uint bytes);
+};
+
+extern AVCapture avCapture;
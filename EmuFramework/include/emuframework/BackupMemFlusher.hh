@@ -0,0 +1,80 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/EmuSystem.hh>
+#include <imagine/base/Timer.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/thread/Semaphore.hh>
+#include <imagine/time/Time.hh>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Periodically copies the save RAM regions reported by EmuSystem::backupMemRegions()
+// on the emulation thread, then compares them against the last written data and
+// writes only the changed ones from a worker thread via a temp file and rename
+class BackupMemFlusher
+{
+public:
+	static constexpr uint CHECK_INTERVAL_SECS = 5;
+
+	struct Stats
+	{
+		uint checks = 0;
+		uint writes = 0;
+		uint64 bytesWritten = 0;
+		IG::Time lastWriteTime{};
+		IG::Time maxWriteTime{};
+	};
+
+	BackupMemFlusher() {}
+	void start();
+	void stop();
+	// snapshots the regions and queues them for writing, returns false if the core reports none
+	bool check();
+	// like check() but waits until any changed regions are on disk
+	bool flush();
+	// forget the written data of the last game so its regions will be compared from scratch
+	void reset();
+	Stats stats();
+
+private:
+	struct Region
+	{
+		std::unique_ptr<uint8[]> snapshot{};
+		std::unique_ptr<uint8[]> written{};
+		size_t size = 0;
+		FS::PathString path{};
+		bool hasWritten = false;
+	};
+
+	Region region[EmuSystem::MAX_BACKUP_MEM_REGIONS]{};
+	uint regions = 0;
+	Base::Timer timer{};
+	IG::Semaphore workerStart{0};
+	IG::Semaphore workerDone{0};
+	std::atomic_bool workerBusy{false};
+	bool workerRunning = false;
+	bool workerPending = false;
+	std::mutex statsMutex{};
+	Stats stats_{};
+
+	void writeRegions();
+	bool writeRegion(Region &r);
+};
+
+extern BackupMemFlusher backupMemFlusher;
@@ -31,7 +31,7 @@ public:
 	void loadFileBrowserItems();
 	void loadStandardItems();
 
-	static const uint STANDARD_ITEMS = 14;
+	static const uint STANDARD_ITEMS = 15;
 	static const uint MAX_SYSTEM_ITEMS = 5;
 
 protected:
@@ -43,6 +43,7 @@ protected:
 	TextMenuItem onScreenInputManager;
 	TextMenuItem inputManager;
 	TextMenuItem benchmark;
+	TextMenuItem benchmarkWithCapture;
 	#ifdef CONFIG_BLUETOOTH
 	TextMenuItem scanWiimotes;
 	std::array<char, 64> bluetoothDisconnectStr{};
@@ -101,6 +101,14 @@ public:
 	using OnLoadProgressDelegate = DelegateFunc<bool(int pos, int max, const char *label)>;
 
 	using Error = std::experimental::optional<std::runtime_error>;
+
+	// frames run by the app's frame scheduler since emulation last started
+	struct FrameStats
+	{
+		uint emulated = 0;
+		uint displayed = 0;
+		uint skipped = 0;
+	};
 	using NameFilterFunc = bool(*)(const char *name);
 	static State state;
 	static FS::PathString savePath_;
@@ -110,6 +118,8 @@ public:
 	static Base::FrameTimeBase timePerVideoFrame;
 	static uint emuFrameNow;
 	static bool runFrameOnDraw;
+	static bool mediaBusy;
+	static FrameStats frameStats;
 	static Audio::PcmFormat pcmFormat;
 	static uint audioFramesPerVideoFrame;
 	static uint aspectRatioX, aspectRatioY;
@@ -136,6 +146,7 @@ public:
 	static bool handlesGenericIO;
 	static bool hasCheats;
 	static bool hasSound;
+	static bool hasVideoFilters;
 	static int forcedSoundRate;
 	static bool constFrameRate;
 	static NameFilterFunc defaultFsFilter;
@@ -174,6 +185,31 @@ public:
 	static char saveSlotChar(int slot);
 	static char saveSlotCharUpper(int slot);
 	static void saveBackupMem();
+	struct BackupMemRegion
+	{
+		const void *data;
+		size_t size;
+		FS::PathString path;
+	};
+	static constexpr uint MAX_BACKUP_MEM_REGIONS = 4;
+	// optional hook listing save RAM areas whose contents are written as-is to a file,
+	// these get flushed in the background while the game runs, returns the region count
+	static uint backupMemRegions(BackupMemRegion (&region)[MAX_BACKUP_MEM_REGIONS]);
+	// optional hooks for in-memory states used by rollback netplay, the state must also
+	// contain the core's input state, stateMemSize() returns 0 if they're unsupported
+	static size_t stateMemSize();
+	static bool saveStateMem(void *buff, size_t size);
+	static bool loadStateMem(const void *buff, size_t size);
+	struct MemSearchRegion
+	{
+		void *data;
+		size_t size;
+		uint32 address; // emulated address of the first byte
+		bool wordSwapped; // big-endian RAM stored as host-endian 16-bit words
+	};
+	static constexpr uint MAX_MEM_SEARCH_REGIONS = 4;
+	// optional hook listing RAM areas for the cheat finder, returns the region count
+	static uint memSearchRegions(MemSearchRegion (&region)[MAX_MEM_SEARCH_REGIONS]);
 	static void savePathChanged();
 	static void reset(ResetMode mode);
 	static void initOptions();
@@ -187,8 +223,15 @@ public:
 	static Error loadGameFromPath(const char *path, OnLoadProgressDelegate onLoadProgress);
 	static Error loadGameFromFile(GenericIO io, const char *name, OnLoadProgressDelegate onLoadProgress);
 	[[gnu::hot]] static void runFrame(EmuVideo *video, bool renderAudio);
+	// runFrame() wrapper used by the app, advances any input movie and when an AV capture is
+	// active always renders video and audio for it, while only the requested output reaches the user
+	// returns false if no frame ran because netplay is waiting on the peer
+	static bool runFrameWithCapture(EmuVideo *video, bool renderAudio);
 	static void skipFrames(uint frames);
+	static void setMediaBusy(bool busy) { mediaBusy = busy; }
+	static uint runMediaBusyFrames(Base::FrameTimeBase frameTimestamp, Base::FrameTimeBase budget);
 	static void onPrepareVideo(EmuVideo &video);
+	static void onPause();
 	static bool vidSysIsPAL();
 	static double frameTime();
 	static double frameTime(VideoSystem system);
@@ -202,6 +245,11 @@ public:
 	static void configFrameTime();
 	static void clearInputBuffers(EmuInputView &view);
 	static void handleInputAction(uint state, uint emuKey);
+	// passes actions from the user to handleInputAction(), recording them or
+	// ignoring them while an input movie is active
+	static void sendInputAction(uint state, uint emuKey);
+	// optional hook returning emuKey changed to act on the given player's controls
+	static uint inputActionForPlayer(uint emuKey, uint player);
 	static uint translateInputAction(uint input, bool &turbo);
 	static uint translateInputAction(uint input)
 	{
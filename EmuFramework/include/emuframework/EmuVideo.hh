@@ -43,6 +43,8 @@ public:
 	}
 
 	void endFrame();
+	// releases the buffer without presenting it, for when nothing was written
+	void cancelFrame();
 
 private:
 	EmuVideo *emuVideo{};
@@ -60,7 +62,12 @@ public:
 	void writeFrame(Gfx::LockedTextureBuffer texBuff);
 	void writeFrame(IG::Pixmap pix);
 	void takeGameScreenshot();
+	// saves every interval-th rendered frame as a numbered screenshot until stopped
+	void startScreenshotBurst(uint interval);
+	void stopScreenshotBurst();
+	uint screenshotBurstInterval() const { return burstInterval; }
 	void renderNextFrameToApp();
+	void cancelRenderNextFrame();
 	bool isExternalTexture();
 	Gfx::PixmapTexture &image();
 	Gfx::Renderer &renderer() { return r; }
@@ -72,6 +79,13 @@ protected:
 	IG::MemPixmap memPix{};
 	bool screenshotNextFrame = false;
 	bool renderNextFrame = false;
+	uint burstInterval = 0;
+	uint burstFrame = 0;
+	int burstNum = 0;
+	uint burstFrames = 0;
+	uint burstDropped = 0;
+	uint burstErrors = 0;
 
 	void doScreenshot(IG::Pixmap pix);
+	void doBurstScreenshot(IG::Pixmap pix);
 };
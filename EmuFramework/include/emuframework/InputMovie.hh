@@ -0,0 +1,111 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/EmuSystem.hh>
+#include <imagine/pixmap/Pixmap.hh>
+#include <imagine/time/Time.hh>
+#include <imagine/base/Timer.hh>
+#include <imagine/util/DelegateFunc.hh>
+#include <memory>
+#include <vector>
+
+// Core-agnostic input log, records the actions passed to EmuSystem::sendInputAction()
+// by emulated frame number starting from a save state, then replays them to reproduce
+// the same run. Frames are counted by EmuSystem::runFrameWithCapture().
+//
+// The .emumovie file, all values little-endian:
+//   header: "EMUMOV01", uint32 frames, uint32 events, uint32 state size, save state data
+//   events: uint32 frame, uint8 type, uint8 input state, uint32 emu key
+class InputMovie
+{
+public:
+	enum class EventType : uint8
+	{
+		INPUT, CLEAR_INPUT, RESET_SOFT, RESET_HARD
+	};
+
+	struct BenchmarkResult
+	{
+		uint frames = 0;
+		IG::Time time{};
+		uint32 crc = 0; // CRC of all the per-frame video CRCs
+		bool hasReference = false;
+		int firstMismatch = -1; // first frame differing from the reference CRC file, or -1 if none
+	};
+
+	using BenchmarkDelegate = DelegateFunc<void (EmuSystem::Error err, const BenchmarkResult &result)>;
+
+	InputMovie() {}
+	EmuSystem::Error startRecording(const char *path);
+	EmuSystem::Error startPlayback(const char *path);
+	// saves the movie file if recording, returns the frames recorded or played
+	uint stop();
+	bool isActive() const { return mode != Mode::OFF; }
+	bool isRecording() const { return mode == Mode::RECORD; }
+	bool isPlaying() const { return mode == Mode::PLAY; }
+	// replays the movie as fast as possible, checking the video CRC of every frame
+	// against <path>.crc, which gets created on the first run. Frames run in short
+	// slices from a timer so the UI stays responsive, onDone gets the result.
+	EmuSystem::Error startBenchmark(const char *path, BenchmarkDelegate onDone);
+	bool isBenchmarking() const { return (bool)onBenchmarkDone; }
+	static FS::PathString defaultPath();
+
+	// called before each emulated frame, applies any played back events
+	void onFrame();
+	// returns true if the action should be passed to the core
+	bool onInputAction(uint state, uint emuKey);
+	// returns true if the core's input buffers should be cleared
+	bool onClearInput();
+	void onReset(EmuSystem::ResetMode resetMode);
+	bool isCheckingVideo() const { return checkVideo; }
+	void addFrameCRC(const IG::Pixmap &pix);
+
+private:
+	enum class Mode : uint8
+	{
+		OFF, RECORD, PLAY
+	};
+	struct Event
+	{
+		uint32 frame;
+		EventType type;
+		uint8 state;
+		uint32 emuKey;
+	};
+
+	Mode mode = Mode::OFF;
+	bool checkVideo = false;
+	uint frame = 0;
+	uint frames = 0;
+	uint nextEvent = 0;
+	std::vector<Event> event{};
+	std::vector<uint32> frameCRC{};
+	std::unique_ptr<char[]> anchorState{};
+	uint anchorStateSize = 0;
+	FS::PathString path{};
+	Base::Timer benchmarkTimer{};
+	BenchmarkDelegate onBenchmarkDone{};
+	IG::Time benchmarkTime{};
+
+	void addEvent(EventType type, uint state = 0, uint emuKey = 0);
+	bool write();
+	void runBenchmarkSlice();
+	void finishBenchmark(EmuSystem::Error err);
+	bool checkBenchmarkReference(BenchmarkResult &result) const;
+};
+
+extern InputMovie inputMovie;
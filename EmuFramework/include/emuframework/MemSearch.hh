@@ -0,0 +1,96 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/EmuSystem.hh>
+#include <imagine/time/Time.hh>
+#include <memory>
+
+// Cheat finder over the RAM regions from EmuSystem::memSearchRegions(). Every
+// aligned value of the chosen width starts as a candidate, each filter compares
+// the candidates to a value or to what they held at the previous filter and
+// keeps the matches in a bitset. Values are unsigned.
+class MemSearch
+{
+public:
+	enum class Width : uint8
+	{
+		BITS_8, BITS_16, BITS_32
+	};
+
+	enum class Compare : uint8
+	{
+		EQUAL, NOT_EQUAL, GREATER, LESS
+	};
+
+	struct Filter
+	{
+		Compare compare = Compare::EQUAL;
+		bool withPrevious = false; // otherwise compares with value
+		uint32 value = 0;
+	};
+
+	struct Result
+	{
+		uint32 address;
+		uint32 value;
+	};
+
+	MemSearch() {}
+	// returns false if the system has no searchable RAM
+	bool start(Width width);
+	void stop();
+	bool isActive() const { return regions; }
+	Width width() const { return width_; }
+	uint candidates() const { return candidates_; }
+	// keeps the candidates matching the filter, returns the count left,
+	// the filter value must fit in the search width
+	uint filter(Filter f);
+	// fills result with up to max candidates in address order, returns the count
+	uint results(Result *result, uint max) const;
+	IG::Time lastFilterTime() const { return filterTime; }
+	bool hasFiltered() const { return filtered; }
+	// re-applies the last filter after every emulated frame
+	void setLive(bool on);
+	bool isLive() const { return live; }
+	void onFrame();
+	static uint widthBytes(Width width) { return 1 << (uint)width; }
+
+private:
+	struct Region
+	{
+		uint8 *data{};
+		size_t size = 0;
+		uint32 address = 0;
+		bool wordSwapped = false;
+		size_t positions = 0;
+		std::unique_ptr<uint8[]> prev{};
+		std::unique_ptr<uint64[]> candidate{};
+	};
+
+	Region region[EmuSystem::MAX_MEM_SEARCH_REGIONS]{};
+	uint regions = 0;
+	uint candidates_ = 0;
+	Width width_ = Width::BITS_8;
+	bool live = false;
+	bool filtered = false;
+	Filter lastFilter{};
+	IG::Time filterTime{};
+
+	uint32 readValue(const Region &r, const uint8 *data, size_t pos) const;
+};
+
+extern MemSearch memSearch;
@@ -0,0 +1,48 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/gui/TableView.hh>
+#include <imagine/gui/MenuItem.hh>
+#include <imagine/util/container/ArrayList.hh>
+#include <emuframework/MemSearch.hh>
+
+class MemSearchView : public TableView
+{
+public:
+	MemSearchView(ViewAttachParams attach);
+	void onShow() override;
+
+protected:
+	TextMenuItem widthItem[3];
+	MultiChoiceMenuItem width;
+	TextMenuItem newSearch;
+	TextMenuItem equal;
+	TextMenuItem greater;
+	TextMenuItem less;
+	TextMenuItem changed;
+	TextMenuItem unchanged;
+	TextMenuItem increased;
+	TextMenuItem decreased;
+	BoolMenuItem live;
+	TextMenuItem results;
+	char resultsText[sizeof("Results (4294967295)")]{};
+	StaticArrayList<MenuItem*, 11> item{};
+
+	void pushValueInput(Input::Event e, MemSearch::Compare compare);
+	void runFilter(MemSearch::Filter filter);
+	void updateResultsText();
+};
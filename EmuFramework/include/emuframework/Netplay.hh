@@ -0,0 +1,182 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/EmuSystem.hh>
+#include <imagine/time/Time.hh>
+#include <imagine/base/Timer.hh>
+#include <imagine/util/DelegateFunc.hh>
+#include <memory>
+
+// Two player rollback netplay over UDP. Both sides start from a hard reset and
+// exchange the actions passed to EmuSystem::sendInputAction() per frame. The
+// remote player is predicted to hold the same keys until its input arrives,
+// when a prediction turns out wrong the core's in-memory state from that frame
+// is restored and the frames since are run again with video and audio off.
+//
+// The loopback mode replaces the remote peer with a simulated one on the same
+// machine, with configurable latency, jitter and packet loss, so the rollback
+// depth and re-simulation cost can be measured without a network. It starts
+// from the current state instead of a reset and restores it when stopped.
+class Netplay
+{
+public:
+	static constexpr uint MAX_ROLLBACK = 12;
+	static constexpr uint DEFAULT_PORT = 47300;
+
+	struct LoopbackConfig
+	{
+		uint latency = 4; // one way, in frames
+		uint jitter = 0;
+		uint lossPercent = 0;
+		bool randomInput = false; // otherwise the simulated player mirrors the local one
+	};
+
+	struct Stats
+	{
+		uint frames = 0;
+		uint stalls = 0; // frames waited for the remote player
+		uint rollbacks = 0;
+		uint resimFrames = 0;
+		uint maxRollback = 0;
+		uint packetsSent = 0;
+		uint packetsReceived = 0;
+		IG::Time resimTime{};
+		IG::Time saveTime{};
+	};
+	using BenchmarkDelegate = DelegateFunc<void (EmuSystem::Error err, const Stats &stats, IG::Time time)>;
+
+	Netplay() {}
+	EmuSystem::Error host(uint port = DEFAULT_PORT);
+	// address is "host[:port]"
+	EmuSystem::Error join(const char *address);
+	EmuSystem::Error startLoopback(LoopbackConfig config);
+	// runs frames as fast as possible against a loopback peer with random input on both sides,
+	// in short slices from a timer so the UI keeps running, then calls onDone
+	EmuSystem::Error startLoopbackBenchmark(LoopbackConfig config, uint frames, BenchmarkDelegate onDone);
+	bool isBenchmarking() const { return (bool)onBenchmarkDone; }
+	void stop();
+	bool isActive() const { return mode != Mode::OFF; }
+	bool isConnected() const { return connected; }
+	bool isLoopback() const { return mode == Mode::LOOPBACK; }
+	const Stats &stats() const { return stats_; }
+
+	// called by EmuSystem::runFrameWithCapture() around each frame,
+	// prepareFrame() returns false if the frame must wait for the remote player
+	bool prepareFrame();
+	void finishFrame();
+	// queues a local action for the next frame
+	void onLocalInputAction(uint state, uint emuKey);
+	// queues releases of all keys held by the local player
+	void releaseLocalInput();
+	// while emulation is paused, keeps exchanging packets so neither side times out
+	void startKeepAlive();
+	void stopKeepAlive();
+
+private:
+	enum class Mode : uint8
+	{
+		OFF, HOST, JOIN, LOOPBACK
+	};
+	static constexpr uint HISTORY = 32; // frames of input kept per player, power of 2
+	static constexpr uint SNAPSHOTS = MAX_ROLLBACK + 1;
+	static constexpr uint MAX_FRAME_EVENTS = 16;
+	static constexpr uint MAX_HELD_KEYS = 16;
+	static constexpr uint LOOPBACK_PACKETS = 64;
+
+	struct InputEvent
+	{
+		uint32 emuKey;
+		uint8 state;
+	};
+	struct FrameInput
+	{
+		uint8 events = 0;
+		InputEvent event[MAX_FRAME_EVENTS]{};
+	};
+	struct LoopbackPacket
+	{
+		uint deliverTick = 0;
+		uint frames = 0; // remote frames ready when sent
+		uint localFrames = 0; // local frames the remote had when sent
+		bool pending = false;
+	};
+
+	Mode mode = Mode::OFF;
+	bool connected = false;
+	uint localPlayer = 0;
+	int sock = -1;
+	char peerAddr[32]{}; // sockaddr_in
+	uint peerAddrLen = 0;
+	IG::Time lastReceiveTime{};
+	IG::Time lastHelloTime{};
+	Base::Timer keepAliveTimer{};
+
+	uint frame = 0; // next frame to run
+	uint remoteFrames = 0; // remote input is known for frames below this
+	uint remoteAck = 0; // the remote has our input for frames below this
+	uint rollbackFrame = ~0u;
+	FrameInput input[2][HISTORY]{};
+	uint32 heldKey[MAX_HELD_KEYS]{};
+	uint heldKeys = 0;
+
+	std::unique_ptr<char[]> snapshot{};
+	size_t snapshotSize = 0;
+	std::unique_ptr<char[]> loopbackStartState{};
+
+	// loopback peer
+	LoopbackConfig loopback{};
+	uint tick = 0;
+	uint loopbackFrames = 0; // frames run by the simulated peer
+	uint loopbackLocalFrames = 0; // local frames the simulated peer has received
+	uint loopbackEchoFrames = 0; // local frames already mirrored
+	uint32 randState = 1;
+	FrameInput loopbackInput[HISTORY]{};
+	LoopbackPacket loopbackPacket[LOOPBACK_PACKETS]{};
+	uint sentFrames[LOOPBACK_PACKETS]{}; // local frames completed at each tick
+	uint loopbackPackets = 0;
+	uint32 loopbackHeld = 0;
+	uint32 localRandomHeld = 0;
+
+	Stats stats_{};
+	Base::Timer benchmarkTimer{};
+	BenchmarkDelegate onBenchmarkDone{};
+	IG::Time benchmarkTime{};
+	uint benchmarkFrames = 0;
+
+	EmuSystem::Error startSession(Mode mode);
+	void beginGame();
+	FrameInput &frameInput(uint player, uint frame) { return input[player][frame % HISTORY]; }
+	char *snapshotData(uint frame) { return &snapshot[(frame % SNAPSHOTS) * snapshotSize]; }
+	void saveSnapshot(uint frame);
+	void applyInput(uint frame);
+	void rollback();
+	void storeRemoteInput(uint frame, const FrameInput &in);
+	void poll();
+	void receivePacket(const uint8 *data, uint size);
+	void sendInput();
+	void sendPacket(const uint8 *data, uint size);
+	void sendHello(uint8 type);
+	void pollLoopback();
+	void runLoopbackPeer();
+	uint32 rand();
+	void toggleRandomDirection(uint32 &held, uint player, FrameInput *in);
+	void runBenchmarkSlice();
+	void finishBenchmark(EmuSystem::Error err);
+	void end(const char *msg);
+};
+
+extern Netplay netplay;
@@ -0,0 +1,41 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/gui/TableView.hh>
+#include <imagine/gui/MenuItem.hh>
+#include <imagine/util/container/ArrayList.hh>
+
+class NetplayView : public TableView
+{
+public:
+	NetplayView(ViewAttachParams attach);
+	void onShow() override;
+
+protected:
+	TextMenuItem host;
+	TextMenuItem join;
+	TextMenuItem loopback;
+	TextMenuItem latencyItem[3];
+	MultiChoiceMenuItem latency;
+	TextMenuItem jitterItem[3];
+	MultiChoiceMenuItem jitter;
+	TextMenuItem lossItem[4];
+	MultiChoiceMenuItem loss;
+	TextMenuItem benchmark;
+	TextMenuItem disconnect;
+	StaticArrayList<MenuItem*, 8> item{};
+};
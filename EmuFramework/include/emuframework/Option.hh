@@ -287,7 +287,8 @@ enum { CFGKEY_SOUND = 0, CFGKEY_TOUCH_CONTROL_DISPLAY = 1,
 	CFGKEY_SKIP_LATE_FRAMES = 76, CFGKEY_FRAME_RATE = 77,
 	CFGKEY_FRAME_RATE_PAL = 78, CFGKEY_TIME_FRAMES_WITH_SCREEN_REFRESH = 79,
 	CFGKEY_SUSTAINED_PERFORMANCE_MODE = 80, CFGKEY_SHOW_BLUETOOTH_SCAN = 81,
-	CFGKEY_LOW_LATENCY_SOUND_HINT = 82
+	CFGKEY_LOW_LATENCY_SOUND_HINT = 82, CFGKEY_VIDEO_FILTER_THREADS = 83,
+	CFGKEY_AUTO_FRAME_SKIP = 84, CFGKEY_MIN_DISPLAY_FPS = 85
 	// 256+ is reserved
 };
 
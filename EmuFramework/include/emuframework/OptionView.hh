@@ -47,6 +47,11 @@ protected:
 	MultiChoiceMenuItem frameInterval;
 	#endif
 	BoolMenuItem dropLateFrames;
+	BoolMenuItem autoFrameSkip;
+	TextMenuItem minDisplayFpsItem[4];
+	MultiChoiceMenuItem minDisplayFps;
+	char frameStatsStr[64]{};
+	TextMenuItem frameStats;
 	char frameRateStr[64]{};
 	TextMenuItem frameRate;
 	char frameRatePALStr[64]{};
@@ -70,6 +75,8 @@ protected:
 	TextMenuItem imgEffectPixelFormatItem[3];
 	MultiChoiceMenuItem imgEffectPixelFormat;
 	#endif
+	TextMenuItem videoFilterThreadsItem[4];
+	MultiChoiceMenuItem videoFilterThreads;
 	#if defined EMU_FRAMEWORK_WINDOW_PIXEL_FORMAT_OPTION
 	TextMenuItem windowPixelFormatItem[5];
 	MultiChoiceMenuItem windowPixelFormat;
@@ -85,7 +92,7 @@ protected:
 	TextHeadingMenuItem screenShapeHeading;
 	TextHeadingMenuItem advancedHeading;
 	TextHeadingMenuItem systemSpecificHeading;
-	StaticArrayList<MenuItem*, 28> item{};
+	StaticArrayList<MenuItem*, 31> item{};
 
 	void pushAndShowFrameRateSelectMenu(EmuSystem::VideoSystem vidSys, Input::Event e);
 	bool onFrameTimeChange(EmuSystem::VideoSystem vidSys, double time);
@@ -93,6 +100,7 @@ protected:
 public:
 	VideoOptionView(ViewAttachParams attach, bool customMenu = false);
 	void loadStockItems();
+	void onShow() override;
 };
 
 class AudioOptionView : public TableView
@@ -126,6 +134,8 @@ protected:
 	char savePathStr[256]{};
 	TextMenuItem savePath;
 	BoolMenuItem checkSavePathWriteAccess;
+	char backupMemStatsStr[64]{};
+	TextMenuItem backupMemStats;
 	static constexpr uint MIN_FAST_FORWARD_SPEED = 2;
 	TextMenuItem fastForwardSpeedItem[6];
 	MultiChoiceMenuItem fastForwardSpeed;
@@ -143,6 +153,7 @@ protected:
 public:
 	SystemOptionView(ViewAttachParams attach, bool customMenu = false);
 	void loadStockItems();
+	void onShow() override;
 };
 
 class GUIOptionView : public TableView
@@ -17,6 +17,53 @@
 
 #include <imagine/pixmap/Pixmap.hh>
 #include <imagine/fs/FS.hh>
+#include <imagine/base/Pipe.hh>
+#include <imagine/thread/Semaphore.hh>
+#include <imagine/util/DelegateFunc.hh>
+#include <mutex>
 
 bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname);
 int sprintScreenshotFilename(FS::PathString &str);
+
+// Encodes and writes screenshots on a worker thread, the caller only pays for
+// copying the frame into one of a small pool of buffers
+class ScreenshotWriter
+{
+public:
+	static constexpr uint BUFFERS = 4;
+	// called on the main thread once the file is written
+	using OnWriteDelegate = DelegateFunc<void(int num, bool success)>;
+
+	ScreenshotWriter() {}
+	// returns false without copying if all buffers are still queued
+	bool write(const IG::Pixmap &pix, FS::PathString path, int num, OnWriteDelegate onWrite);
+	uint pending() const;
+
+private:
+	struct Job
+	{
+		IG::MemPixmap pix{};
+		FS::PathString path{};
+		OnWriteDelegate onWrite{};
+		int num = 0;
+		bool busy = false;
+	};
+	struct DoneMessage
+	{
+		uint8 idx;
+		bool success;
+	};
+
+	Job job[BUFFERS]{};
+	uint8 queue[BUFFERS]{};
+	uint queueStart = 0, queueSize = 0;
+	std::mutex queueMutex{};
+	IG::Semaphore workerStart{0};
+	Base::Pipe donePipe{};
+	bool workerRunning = false;
+
+	void startWorker();
+	void onJobDone(DoneMessage msg);
+};
+
+extern ScreenshotWriter screenshotWriter;
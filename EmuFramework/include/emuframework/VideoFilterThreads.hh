@@ -0,0 +1,50 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/thread/Semaphore.hh>
+#include <imagine/util/DelegateFunc.hh>
+
+// Runs a video filter over horizontal bands of rows in parallel, the calling
+// thread filters the first band and returns once all bands are written
+class VideoFilterThreads
+{
+public:
+	static constexpr uint MAX_THREADS = 4;
+	using BandDelegate = DelegateFunc<void(uint startRow, uint endRow)>;
+
+	VideoFilterThreads() {}
+	void run(uint rows, uint threads, BandDelegate band);
+
+private:
+	struct Worker
+	{
+		IG::Semaphore start{0};
+		bool running = false;
+	};
+
+	Worker worker[MAX_THREADS - 1]{};
+	IG::Semaphore done{0};
+	BandDelegate band{};
+	uint rows = 0;
+	uint bands = 0;
+
+	void runBand(uint idx);
+};
+
+// shared by all cores that filter their video output
+extern VideoFilterThreads videoFilterThreads;
@@ -0,0 +1,333 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "AVCapture"
+#include <emuframework/AVCapture.hh>
+#include <imagine/util/algorithm.h>
+#include <imagine/util/math/int.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+
+AVCapture avCapture{};
+
+static constexpr uint WAV_HEADER_SIZE = 44;
+
+static void writeWavHeader(FileIO &io, Audio::PcmFormat format, uint32 dataBytes)
+{
+	uint32 byteRate = format.framesToBytes(format.rate);
+	uint16 blockAlign = format.framesToBytes(1);
+	uint16 channels = format.channels;
+	uint16 bits = format.sample.toBits();
+	uint32 riffSize = dataBytes + WAV_HEADER_SIZE - 8;
+	uint32 fmtSize = 16;
+	uint16 pcmTag = 1;
+	uint32 rate = format.rate;
+	io.write("RIFF", 4);
+	io.write(&riffSize, 4);
+	io.write("WAVEfmt ", 8);
+	io.write(&fmtSize, 4);
+	io.write(&pcmTag, 2);
+	io.write(&channels, 2);
+	io.write(&rate, 4);
+	io.write(&byteRate, 4);
+	io.write(&blockAlign, 2);
+	io.write(&bits, 2);
+	io.write("data", 4);
+	io.write(&dataBytes, 4);
+}
+
+bool AVCapture::start(FS::PathString basePath, double frameTime, Audio::PcmFormat pcmFormat)
+{
+	assert(!active);
+	auto videoPath = FS::makePathStringPrintf("%s.emucap", basePath.data());
+	auto audioPath = FS::makePathStringPrintf("%s.wav", basePath.data());
+	if(auto ec = videoFile.create(videoPath))
+	{
+		logErr("error creating %s: %s", videoPath.data(), ec.message().c_str());
+		return false;
+	}
+	if(auto ec = audioFile.create(audioPath))
+	{
+		logErr("error creating %s: %s", audioPath.data(), ec.message().c_str());
+		videoFile.close();
+		FS::remove(videoPath);
+		return false;
+	}
+	logMsg("capturing to %s.*", basePath.data());
+	uint64 frameTimeNSecs = frameTime * 1000000000.;
+	videoFile.write("EMUCAP01", 8);
+	videoFile.write(&frameTimeNSecs, 8);
+	this->pcmFormat = pcmFormat;
+	writeWavHeader(audioFile, pcmFormat, 0);
+	stats = {};
+	videoHead = 0;
+	videoTail = 0;
+	pendingDrops = 0;
+	// room for about a second of audio, power of 2 so the free running positions wrap cleanly
+	uint audioBuffBytes = std::max(IG::roundUpPowOf2(pcmFormat.framesToBytes(pcmFormat.rate)), 0x10000u);
+	if(audioBuffSize != audioBuffBytes)
+	{
+		audioBuff = std::make_unique<char[]>(audioBuffBytes);
+		audioBuffSize = audioBuffBytes;
+	}
+	audioHead = 0;
+	audioTail = 0;
+	pendingSilence = 0;
+	prevDesc = {};
+	framesSinceKey = 0;
+	stopRequested = false;
+	IG::makeDetachedThread(
+		[this]()
+		{
+			runWriter();
+		});
+	active = true;
+	return true;
+}
+
+AVCapture::Stats AVCapture::stop()
+{
+	if(!active)
+		return {};
+	active = false;
+	stopRequested.store(true, std::memory_order_release);
+	writerWake.notify();
+	writerDone.wait();
+	// anything dropped after the last queued frame or block
+	iterateTimes(pendingDrops, i)
+	{
+		writeRecord('R', nullptr, 0);
+	}
+	writeSilence(pendingSilence);
+	videoFile.close();
+	audioFile.seekS(0);
+	writeWavHeader(audioFile, pcmFormat, stats.audioBytes);
+	audioFile.close();
+	logMsg("captured %u frames (%u duplicate, %u dropped), %u audio frames dropped, %.2fMB video, %.2fMB audio, writer busy %.3fs",
+		stats.frames, stats.duplicateFrames, stats.droppedFrames, stats.droppedAudioFrames,
+		stats.videoBytes / (1024. * 1024.), stats.audioBytes / (1024. * 1024.), (double)stats.writerTime);
+	return stats;
+}
+
+void AVCapture::writeFrame(const IG::Pixmap &pix)
+{
+	auto head = videoHead.load(std::memory_order_relaxed);
+	if(head - videoTail.load(std::memory_order_acquire) == VIDEO_SLOTS)
+	{
+		pendingDrops++;
+		stats.droppedFrames++;
+		return;
+	}
+	auto &s = slot[head % VIDEO_SLOTS];
+	auto rowBytes = pix.format().pixelBytes(pix.w());
+	auto size = rowBytes * pix.h();
+	if(s.capacity < size)
+	{
+		s.data = std::make_unique<char[]>(size);
+		s.capacity = size;
+	}
+	if(pix.pitchBytes() == rowBytes)
+	{
+		memcpy(s.data.get(), pix.pixel({}), size);
+	}
+	else
+	{
+		auto dest = s.data.get();
+		iterateTimes(pix.h(), y)
+		{
+			memcpy(dest, pix.pixel({0, (int)y}), rowBytes);
+			dest += rowBytes;
+		}
+	}
+	s.desc = pix;
+	s.dropsBefore = pendingDrops;
+	pendingDrops = 0;
+	videoHead.store(head + 1, std::memory_order_release);
+	writerWake.notify();
+}
+
+void AVCapture::writeSound(const void *samples, uint bytes)
+{
+	auto head = audioHead.load(std::memory_order_relaxed);
+	uint used = head - audioTail.load(std::memory_order_acquire);
+	if(audioBuffSize - used < sizeof(AudioBlockHeader) + bytes)
+	{
+		pendingSilence += bytes;
+		stats.droppedAudioFrames += pcmFormat.bytesToFrames(bytes);
+		return;
+	}
+	AudioBlockHeader header{pendingSilence, bytes};
+	pendingSilence = 0;
+	audioRingWrite(head, &header, sizeof(header));
+	audioRingWrite(head + sizeof(header), samples, bytes);
+	audioHead.store(head + sizeof(header) + bytes, std::memory_order_release);
+	writerWake.notify();
+}
+
+void AVCapture::audioRingWrite(uint pos, const void *src, uint bytes)
+{
+	pos &= audioBuffSize - 1;
+	auto firstBytes = std::min(bytes, audioBuffSize - pos);
+	memcpy(&audioBuff[pos], src, firstBytes);
+	memcpy(&audioBuff[0], (const char*)src + firstBytes, bytes - firstBytes);
+}
+
+void AVCapture::audioRingRead(uint pos, void *dest, uint bytes)
+{
+	pos &= audioBuffSize - 1;
+	auto firstBytes = std::min(bytes, audioBuffSize - pos);
+	memcpy(dest, &audioBuff[pos], firstBytes);
+	memcpy((char*)dest + firstBytes, &audioBuff[0], bytes - firstBytes);
+}
+
+void AVCapture::runWriter()
+{
+	for(;;)
+	{
+		writerWake.wait();
+		bool stopping = stopRequested.load(std::memory_order_acquire);
+		auto startTime = IG::Time::now();
+		while(drainVideo() | drainAudio()) {}
+		stats.writerTime += IG::Time::now() - startTime;
+		if(stopping)
+		{
+			writerDone.notify();
+			return;
+		}
+	}
+}
+
+bool AVCapture::drainVideo()
+{
+	auto tail = videoTail.load(std::memory_order_relaxed);
+	auto head = videoHead.load(std::memory_order_acquire);
+	if(tail == head)
+		return false;
+	for(; tail != head; tail++)
+	{
+		auto &s = slot[tail % VIDEO_SLOTS];
+		iterateTimes(s.dropsBefore, i)
+		{
+			writeRecord('R', nullptr, 0);
+		}
+		encodeFrame(s);
+		videoTail.store(tail + 1, std::memory_order_release);
+	}
+	return true;
+}
+
+bool AVCapture::drainAudio()
+{
+	auto tail = audioTail.load(std::memory_order_relaxed);
+	auto head = audioHead.load(std::memory_order_acquire);
+	if(tail == head)
+		return false;
+	while(tail != head)
+	{
+		AudioBlockHeader header;
+		audioRingRead(tail, &header, sizeof(header));
+		writeSilence(header.silenceBefore);
+		uint pos = (tail + sizeof(header)) & (audioBuffSize - 1);
+		auto firstBytes = std::min(header.size, audioBuffSize - pos);
+		audioFile.write(&audioBuff[pos], firstBytes);
+		if(header.size > firstBytes)
+			audioFile.write(&audioBuff[0], header.size - firstBytes);
+		stats.audioBytes += header.size;
+		tail += sizeof(header) + header.size;
+		audioTail.store(tail, std::memory_order_release);
+	}
+	return true;
+}
+
+void AVCapture::encodeFrame(const VideoSlot &s)
+{
+	auto size = s.desc.format().pixelBytes(s.desc.w() * s.desc.h());
+	auto frame = s.data.get();
+	if(s.desc != prevDesc)
+	{
+		prevDesc = s.desc;
+		prevFrame = std::make_unique<char[]>(size);
+		deltaFrame = std::make_unique<char[]>(size);
+		compressedCapacity = compressBound(size);
+		compressed = std::make_unique<char[]>(compressedCapacity);
+		uint32 format[4]{s.desc.w(), s.desc.h(), s.desc.format().bytesPerPixel(), (uint32)s.desc.format().id()};
+		writeRecord('F', format, sizeof(format));
+		framesSinceKey = KEY_FRAME_INTERVAL;
+	}
+	else if(!memcmp(frame, prevFrame.get(), size))
+	{
+		writeRecord('R', nullptr, 0);
+		stats.frames++;
+		stats.duplicateFrames++;
+		return;
+	}
+	bool written;
+	if(framesSinceKey >= KEY_FRAME_INTERVAL)
+	{
+		written = writeCompressedRecord('K', frame, size);
+		framesSinceKey = 0;
+	}
+	else
+	{
+		// unchanged pixels become runs of zeros that deflate well
+		auto delta = deltaFrame.get();
+		auto prev = prevFrame.get();
+		iterateTimes(size, i)
+		{
+			delta[i] = frame[i] ^ prev[i];
+		}
+		written = writeCompressedRecord('D', delta, size);
+	}
+	// the following frame can't be a delta if this one was replaced by a repeat
+	framesSinceKey = written ? framesSinceKey + 1 : KEY_FRAME_INTERVAL;
+	memcpy(prevFrame.get(), frame, size);
+	stats.frames++;
+}
+
+void AVCapture::writeRecord(uint8 type, const void *data, uint32 size)
+{
+	videoFile.write(&type, 1);
+	videoFile.write(&size, 4);
+	if(size)
+		videoFile.write(data, size);
+	stats.videoBytes += 5 + size;
+}
+
+bool AVCapture::writeCompressedRecord(uint8 type, const void *data, size_t size)
+{
+	uLongf compressedSize = compressedCapacity;
+	if(compress2((Bytef*)compressed.get(), &compressedSize, (const Bytef*)data, size, Z_BEST_SPEED) != Z_OK)
+	{
+		logErr("error compressing frame");
+		writeRecord('R', nullptr, 0);
+		return false;
+	}
+	writeRecord(type, compressed.get(), compressedSize);
+	return true;
+}
+
+void AVCapture::writeSilence(uint bytes)
+{
+	static const char zeros[4096]{};
+	stats.audioBytes += bytes;
+	while(bytes)
+	{
+		auto chunk = std::min(bytes, (uint)sizeof(zeros));
+		audioFile.write(zeros, chunk);
+		bytes -= chunk;
+	}
+}
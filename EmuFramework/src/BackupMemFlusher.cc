@@ -0,0 +1,190 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "BackupMem"
+#include <emuframework/BackupMemFlusher.hh>
+#include <imagine/thread/Thread.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/util/algorithm.h>
+#include <imagine/util/string.h>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <cstring>
+
+BackupMemFlusher backupMemFlusher{};
+
+void BackupMemFlusher::start()
+{
+	timer.callbackAfterSec(
+		[this]()
+		{
+			check();
+		}, CHECK_INTERVAL_SECS, CHECK_INTERVAL_SECS, {});
+}
+
+void BackupMemFlusher::stop()
+{
+	timer.deinit();
+}
+
+bool BackupMemFlusher::check()
+{
+	if(workerPending)
+	{
+		if(workerBusy.load(std::memory_order_acquire))
+		{
+			// previous write still in progress, try again next interval
+			return true;
+		}
+		workerDone.wait();
+		workerPending = false;
+	}
+	EmuSystem::BackupMemRegion info[EmuSystem::MAX_BACKUP_MEM_REGIONS]{};
+	regions = std::min(EmuSystem::backupMemRegions(info), EmuSystem::MAX_BACKUP_MEM_REGIONS);
+	if(!regions)
+		return false;
+	iterateTimes(regions, i)
+	{
+		auto &r = region[i];
+		if(r.size != info[i].size || !string_equal(r.path.data(), info[i].path.data()))
+		{
+			// new region, the worker compares against the existing file first
+			r.snapshot = std::make_unique<uint8[]>(info[i].size);
+			r.written = std::make_unique<uint8[]>(info[i].size);
+			r.size = info[i].size;
+			r.path = info[i].path;
+			r.hasWritten = false;
+		}
+		memcpy(r.snapshot.get(), info[i].data, r.size);
+	}
+	{
+		std::lock_guard<std::mutex> lock{statsMutex};
+		stats_.checks++;
+	}
+	if(!workerRunning)
+	{
+		workerRunning = true;
+		IG::makeDetachedThread(
+			[this]()
+			{
+				for(;;)
+				{
+					workerStart.wait();
+					writeRegions();
+					workerBusy.store(false, std::memory_order_release);
+					workerDone.notify();
+				}
+			});
+	}
+	workerBusy.store(true, std::memory_order_relaxed);
+	workerPending = true;
+	workerStart.notify();
+	return true;
+}
+
+bool BackupMemFlusher::flush()
+{
+	if(workerPending)
+	{
+		workerDone.wait();
+		workerPending = false;
+	}
+	if(!check())
+		return false;
+	workerDone.wait();
+	workerPending = false;
+	return true;
+}
+
+void BackupMemFlusher::reset()
+{
+	if(workerPending)
+	{
+		workerDone.wait();
+		workerPending = false;
+	}
+	iterateTimes(regions, i)
+	{
+		region[i] = {};
+	}
+	regions = 0;
+}
+
+BackupMemFlusher::Stats BackupMemFlusher::stats()
+{
+	std::lock_guard<std::mutex> lock{statsMutex};
+	return stats_;
+}
+
+void BackupMemFlusher::writeRegions()
+{
+	iterateTimes(regions, i)
+	{
+		auto &r = region[i];
+		auto startTime = IG::Time::now();
+		if(!writeRegion(r))
+			continue;
+		auto writeTime = IG::Time::now() - startTime;
+		logMsg("wrote %zu bytes to %s in %.3fms", r.size, r.path.data(), (double)writeTime * 1000.);
+		std::lock_guard<std::mutex> lock{statsMutex};
+		stats_.writes++;
+		stats_.bytesWritten += r.size;
+		stats_.lastWriteTime = writeTime;
+		stats_.maxWriteTime = std::max(stats_.maxWriteTime, writeTime);
+	}
+}
+
+bool BackupMemFlusher::writeRegion(Region &r)
+{
+	if(!r.hasWritten)
+	{
+		FileIO file;
+		if(!file.open(r.path, IO::AccessHint::ALL) && file.size() == r.size &&
+			file.read(r.written.get(), r.size) == (ssize_t)r.size)
+		{
+			r.hasWritten = true;
+		}
+	}
+	if(r.hasWritten && !memcmp(r.snapshot.get(), r.written.get(), r.size))
+		return false;
+	auto tempPath = FS::makePathStringPrintf("%s.tmp", r.path.data());
+	{
+		FileIO file;
+		if(auto ec = file.create(tempPath))
+		{
+			logErr("error creating %s: %s", tempPath.data(), ec.message().c_str());
+			return false;
+		}
+		if(file.write(r.snapshot.get(), r.size) != (ssize_t)r.size)
+		{
+			logErr("error writing %s", tempPath.data());
+			file.close();
+			FS::remove(tempPath);
+			return false;
+		}
+		file.sync();
+	}
+	std::error_code ec{};
+	FS::rename(tempPath, r.path, ec);
+	if(ec)
+	{
+		logErr("error renaming %s: %s", tempPath.data(), ec.message().c_str());
+		FS::remove(tempPath);
+		return false;
+	}
+	std::swap(r.snapshot, r.written);
+	r.hasWritten = true;
+	return true;
+}
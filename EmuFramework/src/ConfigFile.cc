@@ -195,6 +195,9 @@ static bool readConfig2(IO &io)
 			bcase CFGKEY_FRAME_INTERVAL: optionFrameInterval.readFromIO(io, size);
 			#endif
 			bcase CFGKEY_SKIP_LATE_FRAMES: optionSkipLateFrames.readFromIO(io, size);
+			bcase CFGKEY_AUTO_FRAME_SKIP: optionAutoFrameSkip.readFromIO(io, size);
+			bcase CFGKEY_MIN_DISPLAY_FPS: optionMinDisplayFps.readFromIO(io, size);
+			bcase CFGKEY_VIDEO_FILTER_THREADS: optionVideoFilterThreads.readFromIO(io, size);
 			bcase CFGKEY_FRAME_RATE: optionFrameRate.readFromIO(io, size);
 			bcase CFGKEY_FRAME_RATE_PAL: optionFrameRatePAL.readFromIO(io, size);
 			#if defined(CONFIG_BASE_ANDROID)
@@ -467,6 +470,9 @@ static OptionBase *cfgFileOption[] =
 	&optionFrameInterval,
 	#endif
 	&optionSkipLateFrames,
+	&optionAutoFrameSkip,
+	&optionMinDisplayFps,
+	&optionVideoFilterThreads,
 	&optionFrameRate,
 	&optionFrameRatePAL,
 	&optionVibrateOnPush,
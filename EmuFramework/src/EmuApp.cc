@@ -21,6 +21,9 @@
 #include <emuframework/EmuView.hh>
 #include <emuframework/EmuLoadProgressView.hh>
 #include <emuframework/FileUtils.hh>
+#include <emuframework/AVCapture.hh>
+#include <emuframework/InputMovie.hh>
+#include <emuframework/Netplay.hh>
 #include <imagine/gui/AlertView.hh>
 #include <imagine/util/utility.h>
 #include <imagine/util/ScopeGuard.hh>
@@ -230,8 +233,19 @@ static void drawEmuVideo(Gfx::Renderer &r)
 	r.presentDrawable(emuWin->drawable);
 }
 
+// moving averages of runFrame() cost in seconds, with and without video, for auto frame skip
+static double videoFrameCost = 0, skipFrameCost = 0;
+static IG::Time videoFrameDoneTime{};
+static Base::FrameTimeBase lastDisplayedFrameTime = 0;
+
+static void updateFrameCost(double &avg, double cost)
+{
+	avg = avg ? avg + (cost - avg) / 8. : cost;
+}
+
 void updateAndDrawEmuVideo()
 {
+	videoFrameDoneTime = IG::Time::now();
 	drawEmuVideo(renderer);
 }
 
@@ -320,8 +334,21 @@ static void drawEmuFrame(Gfx::Renderer &r)
 	{
 		bool renderAudio = optionSound;
 		emuVideo.renderNextFrameToApp();
-		EmuSystem::runFrame(&emuVideo, renderAudio);
+		auto startTime = IG::Time::now();
+		videoFrameDoneTime = {};
 		EmuSystem::runFrameOnDraw = false;
+		if(!EmuSystem::runFrameWithCapture(&emuVideo, renderAudio))
+		{
+			// netplay is waiting on the peer, present the last frame so popups still update
+			emuVideo.cancelRenderNextFrame();
+			drawEmuVideo(r);
+			return;
+		}
+		// leave out presenting the frame since it can block until vsync
+		auto endTime = videoFrameDoneTime.nSecs() ? videoFrameDoneTime : IG::Time::now();
+		updateFrameCost(videoFrameCost, (double)(endTime - startTime));
+		EmuSystem::frameStats.emulated++;
+		EmuSystem::frameStats.displayed++;
 	}
 	else
 	{
@@ -329,6 +356,38 @@ static void drawEmuFrame(Gfx::Renderer &r)
 	}
 }
 
+static void runAutoFrameSkip(Base::Screen::FrameParams params, uint frames)
+{
+	// emulate every elapsed frame so audio keeps up, and only display the last one
+	// if its cost fits in the host frame or the minimum display rate requires it
+	constexpr uint maxAutoFrameSkip = 30;
+	uint framesToSkip = std::min(frames - 1, maxAutoFrameSkip);
+	double skipCost = skipFrameCost ? skipFrameCost : videoFrameCost;
+	auto minDisplayInterval = Base::frameTimeBaseFromSecs(1. / optionMinDisplayFps);
+	bool displayDue = !lastDisplayedFrameTime ||
+		params.timestamp() - lastDisplayedFrameTime >= minDisplayInterval;
+	bool display = displayDue ||
+		videoFrameCost + framesToSkip * skipCost <= params.screen().frameTime();
+	if(!display)
+		framesToSkip++;
+	bool renderAudio = optionSound;
+	iterateTimes(framesToSkip, i)
+	{
+		auto startTime = IG::Time::now();
+		if(!EmuSystem::runFrameWithCapture(nullptr, renderAudio))
+			continue;
+		updateFrameCost(skipFrameCost, (double)(IG::Time::now() - startTime));
+		EmuSystem::frameStats.emulated++;
+		EmuSystem::frameStats.skipped++;
+	}
+	if(display)
+	{
+		lastDisplayedFrameTime = params.timestamp();
+		EmuSystem::runFrameOnDraw = true;
+		postDrawToEmuWindows();
+	}
+}
+
 static bool allWindowsAreFocused()
 {
 	return mainWin.focused && (!extraWin.win || extraWin.focused);
@@ -773,7 +832,11 @@ void mainInitCommon(int argc, char** argv)
 			{
 				uint frames = EmuSystem::advanceFramesWithTime(params.timestamp());
 				//logDMsg("%d frames elapsed (%fs)", frames, Base::frameTimeBaseToSecsDec(params.frameTimeDiff()));
-				if(frames)
+				if(frames && optionAutoFrameSkip)
+				{
+					runAutoFrameSkip(params, frames);
+				}
+				else if(frames)
 				{
 					EmuSystem::runFrameOnDraw = true;
 					postDrawToEmuWindows();
@@ -791,10 +854,20 @@ void mainInitCommon(int argc, char** argv)
 						bool renderAudio = optionSound;
 						iterateTimes(framesToSkip, i)
 						{
-							EmuSystem::runFrame(nullptr, renderAudio);
+							if(EmuSystem::runFrameWithCapture(nullptr, renderAudio))
+							{
+								EmuSystem::frameStats.emulated++;
+								EmuSystem::frameStats.skipped++;
+							}
 						}
 					}
 				}
+				if(frames && unlikely(EmuSystem::mediaBusy))
+				{
+					// spend up to half the host frame fast-forwarding through loading
+					auto budget = Base::frameTimeBaseFromSecs(params.screen().frameTime() / 2.);
+					EmuSystem::runMediaBusyFrames(params.timestamp(), budget);
+				}
 			}
 			params.readdOnFrame();
 		};
@@ -1128,10 +1201,32 @@ void onSelectFileFromPicker(Gfx::Renderer &r, const char* name, Input::Event e)
 		});
 }
 
-void runBenchmarkOneShot()
+void runBenchmarkOneShot(bool withAVCapture)
 {
 	logMsg("starting benchmark");
+	auto captureBasePath = FS::makePathStringPrintf("%s/%s.benchmark", EmuSystem::savePath(), EmuSystem::gameName().data());
+	if(withAVCapture && !avCapture.start(captureBasePath, EmuSystem::frameTime(), EmuSystem::pcmFormat))
+	{
+		EmuSystem::closeGame(false);
+		popup.postError("Error creating capture files");
+		return;
+	}
+	auto startTime = IG::Time::now();
 	IG::Time time = EmuSystem::benchmark();
+	if(withAVCapture)
+	{
+		auto stats = avCapture.stop();
+		// throughput includes waiting for the writer to finish the queued data
+		double totalTime = IG::Time::now() - startTime;
+		double mbWritten = (stats.videoBytes + stats.audioBytes) / (1024. * 1024.);
+		FS::remove(FS::makePathStringPrintf("%s.emucap", captureBasePath.data()));
+		FS::remove(FS::makePathStringPrintf("%s.wav", captureBasePath.data()));
+		EmuSystem::closeGame(false);
+		logMsg("done in: %f, capture total: %f, writer busy: %f", double(time), totalTime, double(stats.writerTime));
+		popup.printf(4, 0, "%.2f fps, %u/180 frames dropped\n%.2f MB/s capture output",
+			double(180.)/double(time), stats.droppedFrames, mbWritten / totalTime);
+		return;
+	}
 	EmuSystem::closeGame(false);
 	logMsg("done in: %f", double(time));
 	popup.printf(2, 0, "%.2f fps", double(180.)/double(time));
@@ -1399,6 +1494,9 @@ EmuSystem::Error EmuApp::loadState(const char *path)
 		return EmuSystem::makeError("File doesn't exist");
 	}
 	fixFilePermissions(path);
+	// a movie or netplay session can't continue from a different state
+	inputMovie.stop();
+	netplay.stop();
 	logMsg("loading state %s", path);
 	return EmuSystem::loadState(path);
 }
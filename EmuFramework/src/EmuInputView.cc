@@ -253,7 +253,7 @@ bool EmuInputView::inputEvent(Input::Event e)
 								turboActions.removeEvent(sysAction);
 							}
 						}
-						EmuSystem::handleInputAction(e.state(), sysAction);
+						EmuSystem::sendInputAction(e.state(), sysAction);
 					}
 				}
 			}
@@ -28,6 +28,7 @@
 #include <emuframework/InputManagerView.hh>
 #include <emuframework/TouchConfigView.hh>
 #include <emuframework/BundledGamesView.hh>
+#include <emuframework/InputMovie.hh>
 #include "private.hh"
 #ifdef CONFIG_BLUETOOTH
 #include <imagine/bluetooth/sys.hh>
@@ -63,6 +64,7 @@ public:
 			{
 				dismiss();
 				EmuSystem::reset(EmuSystem::RESET_SOFT);
+				inputMovie.onReset(EmuSystem::RESET_SOFT);
 				startGameFromMenu();
 			}
 		},
@@ -73,6 +75,7 @@ public:
 			{
 				dismiss();
 				EmuSystem::reset(EmuSystem::RESET_HARD);
+				inputMovie.onReset(EmuSystem::RESET_HARD);
 				startGameFromMenu();
 			}
 		},
@@ -213,6 +216,7 @@ void EmuMainMenuView::loadStandardItems()
 	}
 	#endif
 	item.emplace_back(&benchmark);
+	item.emplace_back(&benchmarkWithCapture);
 	item.emplace_back(&about);
 	item.emplace_back(&exitApp);
 }
@@ -295,6 +299,15 @@ EmuMainMenuView::EmuMainMenuView(ViewAttachParams attach, bool customMenu):
 			pushAndShow(fPicker, e, false);
 		}
 	},
+	benchmarkWithCapture
+	{
+		"Benchmark Game With Recording",
+		[this](TextMenuItem &, View &, Input::Event e)
+		{
+			auto &fPicker = *EmuFilePicker::makeForBenchmarking(attachParams(), e, false, true);
+			pushAndShow(fPicker, e, false);
+		}
+	},
 	#ifdef CONFIG_BLUETOOTH
 	scanWiimotes
 	{
@@ -17,6 +17,7 @@
 #include <emuframework/EmuSystem.hh>
 #include <emuframework/EmuApp.hh>
 #include <emuframework/VideoImageEffect.hh>
+#include <emuframework/VideoFilterThreads.hh>
 #include <emuframework/VController.hh>
 #include "private.hh"
 #include "privateInput.hh"
@@ -202,8 +203,12 @@ Byte1Option optionFrameInterval
 	{CFGKEY_FRAME_INTERVAL,	1, !Config::envIsIOS, optionIsValidWithMinMax<1, 4>};
 #endif
 Byte1Option optionSkipLateFrames{CFGKEY_SKIP_LATE_FRAMES, 1, 0};
+Byte1Option optionAutoFrameSkip{CFGKEY_AUTO_FRAME_SKIP, 0, 0};
+Byte1Option optionMinDisplayFps{CFGKEY_MIN_DISPLAY_FPS, 15, 0, optionIsValidWithMinMax<1, 60>};
 DoubleOption optionFrameRate{CFGKEY_FRAME_RATE, 0, 0, optionFrameTimeIsValid};
 DoubleOption optionFrameRatePAL{CFGKEY_FRAME_RATE_PAL, 1./50., !EmuSystem::hasPALVideoSystem, optionFrameTimePALIsValid};
+Byte1Option optionVideoFilterThreads{CFGKEY_VIDEO_FILTER_THREADS, 2, !EmuSystem::hasVideoFilters,
+	optionIsValidWithMinMax<1, VideoFilterThreads::MAX_THREADS>};
 
 bool optionImageZoomIsValid(uint8 val)
 {
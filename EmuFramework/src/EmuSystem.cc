@@ -18,6 +18,11 @@
 #include <emuframework/EmuApp.hh>
 #include <emuframework/FileUtils.hh>
 #include <emuframework/FilePicker.hh>
+#include <emuframework/BackupMemFlusher.hh>
+#include <emuframework/AVCapture.hh>
+#include <emuframework/InputMovie.hh>
+#include <emuframework/Netplay.hh>
+#include <emuframework/MemSearch.hh>
 #include <imagine/fs/ArchiveFS.hh>
 #include <imagine/audio/OutputStream.hh>
 #include <imagine/util/utility.h>
@@ -41,6 +46,8 @@ Base::FrameTimeBase EmuSystem::startFrameTime = 0;
 Base::FrameTimeBase EmuSystem::timePerVideoFrame = 0;
 uint EmuSystem::emuFrameNow = 0;
 bool EmuSystem::runFrameOnDraw = false;
+bool EmuSystem::mediaBusy = false;
+EmuSystem::FrameStats EmuSystem::frameStats{};
 int EmuSystem::saveStateSlot = 0;
 Audio::PcmFormat EmuSystem::pcmFormat = {44100, Audio::SampleFormats::s16, 2};
 uint EmuSystem::audioFramesPerVideoFrame = 0;
@@ -56,11 +63,13 @@ double EmuSystem::frameTimePAL = 1./50.;
 [[gnu::weak]] bool EmuSystem::handlesGenericIO = true;
 [[gnu::weak]] bool EmuSystem::hasCheats = false;
 [[gnu::weak]] bool EmuSystem::hasSound = true;
+[[gnu::weak]] bool EmuSystem::hasVideoFilters = false;
 [[gnu::weak]] int EmuSystem::forcedSoundRate = 0;
 [[gnu::weak]] bool EmuSystem::constFrameRate = false;
 static std::unique_ptr<Audio::SysOutputStream> audioStream;
 static IG::SysRingBuffer rBuff{};
 static bool audioWriteActive = false;
+static bool captureOnlySound = false; // sound is rendered for an AV capture but not played
 
 static int audioFramesFree()
 {
@@ -190,9 +199,53 @@ void EmuSystem::flushSound()
 	}
 }
 
+bool EmuSystem::runFrameWithCapture(EmuVideo *video, bool renderAudio)
+{
+	if(unlikely(netplay.isActive()) && !netplay.prepareFrame())
+		return false;
+	if(unlikely(inputMovie.isActive()))
+	{
+		inputMovie.onFrame();
+	}
+	if(likely(!avCapture.isActive()))
+	{
+		runFrame(video, renderAudio);
+	}
+	else
+	{
+		captureOnlySound = !renderAudio;
+		runFrame(video ? video : &emuVideo, true);
+		captureOnlySound = false;
+	}
+	if(unlikely(netplay.isActive()))
+		netplay.finishFrame();
+	if(unlikely(memSearch.isLive()))
+		memSearch.onFrame();
+	return true;
+}
+
+void EmuSystem::sendInputAction(uint state, uint emuKey)
+{
+	if(unlikely(netplay.isActive()))
+	{
+		// applied at a fixed frame on both sides
+		netplay.onLocalInputAction(state, emuKey);
+		return;
+	}
+	if(unlikely(inputMovie.isActive()) && !inputMovie.onInputAction(state, emuKey))
+		return;
+	handleInputAction(state, emuKey);
+}
+
 void EmuSystem::writeSound(const void *samples, uint framesToWrite)
 {
 	uint bytes = pcmFormat.framesToBytes(framesToWrite);
+	if(unlikely(avCapture.isActive()))
+	{
+		avCapture.writeSound(samples, bytes);
+		if(captureOnlySound)
+			return;
+	}
 	uint freeBytes = rBuff.freeSpace();
 	if(bytes <= freeBytes)
 	{
@@ -422,13 +475,24 @@ void EmuSystem::closeGame(bool allowAutosaveState)
 {
 	if(gameIsRunning())
 	{
+		// let threaded systems finish any frame still writing audio or video
+		onPause();
 		flushSound();
 		if(allowAutosaveState)
 			EmuApp::saveAutoState();
 		logMsg("closing game %s", gameName_.data());
+		emuVideo.stopScreenshotBurst();
+		avCapture.stop();
+		inputMovie.stop();
+		netplay.stop();
+		memSearch.stop();
 		closeSystem();
+		backupMemFlusher.stop();
+		backupMemFlusher.reset();
+		mediaBusy = false;
 		cancelAutoSaveStateTimer();
 		viewStack.navView()->showRightBtn(false);
+		frameStats = {};
 		state = State::OFF;
 	}
 	clearGamePaths();
@@ -441,19 +505,34 @@ void EmuSystem::resetFrameTime()
 
 void EmuSystem::pause()
 {
+	onPause();
 	if(isActive())
 		state = State::PAUSED;
+	if(unlikely(netplay.isActive()))
+		netplay.startKeepAlive();
 	stopSound();
 	cancelAutoSaveStateTimer();
+	backupMemFlusher.stop();
 }
 
 void EmuSystem::start()
 {
 	state = State::ACTIVE;
-	clearInputBuffers(emuInputView);
+	if(unlikely(inputMovie.isBenchmarking()))
+		inputMovie.stop(); // the user took over, the benchmark reports it was interrupted
+	if(unlikely(netplay.isBenchmarking()))
+		netplay.stop();
+	if(unlikely(netplay.isActive()))
+	{
+		netplay.stopKeepAlive();
+		netplay.releaseLocalInput();
+	}
+	else if(inputMovie.onClearInput())
+		clearInputBuffers(emuInputView);
 	resetFrameTime();
 	startSound();
 	startAutoSaveStateTimer();
+	backupMemFlusher.start();
 }
 
 IG::Time EmuSystem::benchmark()
@@ -461,7 +540,7 @@ IG::Time EmuSystem::benchmark()
 	auto now = IG::Time::now();
 	iterateTimes(180, i)
 	{
-		runFrame(&emuVideo, false);
+		runFrameWithCapture(&emuVideo, false);
 	}
 	auto after = IG::Time::now();
 	return after-now;
@@ -473,10 +552,36 @@ void EmuSystem::skipFrames(uint frames)
 		return;
 	iterateTimes(frames, i)
 	{
-		runFrame(nullptr, false);
+		if(runFrameWithCapture(nullptr, false))
+		{
+			frameStats.emulated++;
+			frameStats.skipped++;
+		}
 	}
 }
 
+// Runs skipped frames while the core reports disk/tape activity with setMediaBusy(),
+// stopping before the next frame would end past budget from the frame timestamp
+uint EmuSystem::runMediaBusyFrames(Base::FrameTimeBase frameTimestamp, Base::FrameTimeBase budget)
+{
+	static constexpr uint maxFrames = 256;
+	uint frames = 0;
+	auto elapsed = Base::timeSinceFrameTime(frameTimestamp);
+	Base::FrameTimeBase frameCost = 0;
+	while(mediaBusy && frames < maxFrames && elapsed + frameCost < budget)
+	{
+		if(!runFrameWithCapture(nullptr, false))
+			break;
+		frames++;
+		frameStats.emulated++;
+		frameStats.skipped++;
+		auto now = Base::timeSinceFrameTime(frameTimestamp);
+		frameCost = now - elapsed;
+		elapsed = now;
+	}
+	return frames;
+}
+
 void EmuSystem::configFrameTime()
 {
 	pcmFormat.rate = optionSoundRate;
@@ -710,6 +815,18 @@ char EmuSystem::saveSlotCharUpper(int slot)
 
 [[gnu::weak]] void EmuSystem::saveBackupMem() {}
 
+[[gnu::weak]] uint EmuSystem::backupMemRegions(BackupMemRegion (&)[MAX_BACKUP_MEM_REGIONS]) { return 0; }
+
+[[gnu::weak]] size_t EmuSystem::stateMemSize() { return 0; }
+
+[[gnu::weak]] bool EmuSystem::saveStateMem(void *buff, size_t size) { return false; }
+
+[[gnu::weak]] bool EmuSystem::loadStateMem(const void *buff, size_t size) { return false; }
+
+[[gnu::weak]] uint EmuSystem::memSearchRegions(MemSearchRegion (&)[MAX_MEM_SEARCH_REGIONS]) { return 0; }
+
+[[gnu::weak]] uint EmuSystem::inputActionForPlayer(uint emuKey, uint player) { return emuKey; }
+
 [[gnu::weak]] void EmuSystem::savePathChanged() {}
 
 [[gnu::weak]] uint EmuSystem::multiresVideoBaseX() { return 0; }
@@ -724,6 +841,8 @@ char EmuSystem::saveSlotCharUpper(int slot)
 
 [[gnu::weak]] void EmuSystem::onPrepareVideo(EmuVideo &video) {}
 
+[[gnu::weak]] void EmuSystem::onPause() {}
+
 [[gnu::weak]] FS::FileString EmuSystem::fullGameNameForPath(const char *path)
 {
 	return fullGameNameForPathDefaultImpl(path);
@@ -27,6 +27,11 @@
 #include <emuframework/InputManagerView.hh>
 #include <emuframework/TouchConfigView.hh>
 #include <emuframework/BundledGamesView.hh>
+#include <emuframework/AVCapture.hh>
+#include <emuframework/InputMovie.hh>
+#include <emuframework/Netplay.hh>
+#include <emuframework/NetplayView.hh>
+#include <emuframework/MemSearchView.hh>
 #include "private.hh"
 
 class ResetAlertView : public BaseAlertView
@@ -55,6 +60,7 @@ public:
 			{
 				dismiss();
 				EmuSystem::reset(EmuSystem::RESET_SOFT);
+				inputMovie.onReset(EmuSystem::RESET_SOFT);
 				startGameFromMenu();
 			}
 		},
@@ -65,6 +71,7 @@ public:
 			{
 				dismiss();
 				EmuSystem::reset(EmuSystem::RESET_HARD);
+				inputMovie.onReset(EmuSystem::RESET_HARD);
 				startGameFromMenu();
 			}
 		},
@@ -82,16 +89,57 @@ protected:
 	TextMenuItem soft, hard, cancel;
 };
 
+static bool startAVCapture()
+{
+	const uint maxNum = 999;
+	iterateTimes(maxNum, i)
+	{
+		auto basePath = FS::makePathStringPrintf("%s/%s.capture%.3d", EmuSystem::savePath(), EmuSystem::gameName().data(), i);
+		if(FS::exists(FS::makePathStringPrintf("%s.emucap", basePath.data())))
+			continue;
+		if(!avCapture.start(basePath, EmuSystem::frameTime(), EmuSystem::pcmFormat))
+		{
+			popup.postError("Error creating capture files");
+			return false;
+		}
+		popup.printf(2, 0, "Recording to capture #%d", i);
+		return true;
+	}
+	popup.postError("Too many captures");
+	return false;
+}
+
+static void stopAVCapture()
+{
+	auto stats = avCapture.stop();
+	if(stats.droppedFrames)
+		popup.printf(3, 0, "Recorded %u frames, dropped %u", stats.frames + stats.droppedFrames, stats.droppedFrames);
+	else
+		popup.printf(2, 0, "Recorded %u frames", stats.frames);
+}
+
 void EmuSystemActionsView::onShow()
 {
 	logMsg("refreshing action menu state");
 	cheats.setActive(EmuSystem::gameIsRunning());
-	reset.setActive(EmuSystem::gameIsRunning());
+	// both netplay sides must run the same frames
+	reset.setActive(EmuSystem::gameIsRunning() && !::netplay.isActive());
 	saveState.setActive(EmuSystem::gameIsRunning());
-	loadState.setActive(EmuSystem::gameIsRunning() && EmuSystem::stateExists(EmuSystem::saveStateSlot));
+	loadState.setActive(EmuSystem::gameIsRunning() && !::netplay.isActive() && EmuSystem::stateExists(EmuSystem::saveStateSlot));
 	stateSlotText[12] = EmuSystem::saveSlotChar(EmuSystem::saveStateSlot);
 	stateSlot.compile(renderer(), projP);
 	screenshot.setActive(EmuSystem::gameIsRunning());
+	screenshotBurst.setActive(EmuSystem::gameIsRunning());
+	recordAV.setActive(EmuSystem::gameIsRunning());
+	recordAV.setBoolValue(avCapture.isActive());
+	recordMovie.setActive(EmuSystem::gameIsRunning() && !inputMovie.isPlaying() && !::netplay.isActive());
+	recordMovie.setBoolValue(inputMovie.isRecording());
+	bool canPlayMovie = EmuSystem::gameIsRunning() && !inputMovie.isRecording() && !::netplay.isActive() && FS::exists(InputMovie::defaultPath());
+	playMovie.setActive(canPlayMovie);
+	benchmarkMovie.setActive(canPlayMovie);
+	netplay.setActive(EmuSystem::gameIsRunning());
+	EmuSystem::MemSearchRegion region[EmuSystem::MAX_MEM_SEARCH_REGIONS];
+	memSearch.setActive(EmuSystem::gameIsRunning() && EmuSystem::memSearchRegions(region));
 	#if defined CONFIG_BASE_ANDROID && !defined CONFIG_MACHINE_OUYA
 	addLauncherIcon.setActive(EmuSystem::gameIsRunning());
 	#endif
@@ -113,6 +161,13 @@ void EmuSystemActionsView::loadStandardItems()
 	item.emplace_back(&addLauncherIcon);
 	#endif
 	item.emplace_back(&screenshot);
+	item.emplace_back(&screenshotBurst);
+	item.emplace_back(&recordAV);
+	item.emplace_back(&recordMovie);
+	item.emplace_back(&playMovie);
+	item.emplace_back(&benchmarkMovie);
+	item.emplace_back(&netplay);
+	item.emplace_back(&memSearch);
 	item.emplace_back(&close);
 }
 
@@ -133,9 +188,9 @@ EmuSystemActionsView::EmuSystemActionsView(ViewAttachParams attach, bool customM
 	reset
 	{
 		"Reset",
-		[this](TextMenuItem &, View &, Input::Event e)
+		[this](TextMenuItem &item, View &, Input::Event e)
 		{
-			if(EmuSystem::gameIsRunning())
+			if(item.active() && EmuSystem::gameIsRunning())
 			{
 				if(EmuSystem::hasResetModes)
 				{
@@ -150,6 +205,7 @@ EmuSystemActionsView::EmuSystemActionsView(ViewAttachParams attach, bool customM
 						{
 							view.dismiss();
 							EmuSystem::reset(EmuSystem::RESET_SOFT);
+							inputMovie.onReset(EmuSystem::RESET_SOFT);
 							startGameFromMenu();
 						});
 					modalViewController.pushAndShow(ynAlertView, e, false);
@@ -269,8 +325,150 @@ EmuSystemActionsView::EmuSystemActionsView(ViewAttachParams attach, bool customM
 			if(EmuSystem::gameIsRunning())
 			{
 				emuVideo.takeGameScreenshot();
-				EmuSystem::runFrame(&emuVideo, false);
+				EmuSystem::runFrameWithCapture(&emuVideo, false);
+			}
+		}
+	},
+	screenshotBurstItem
+	{
+		{"Off", []() { emuVideo.stopScreenshotBurst(); }},
+		{"Every Frame", []() { emuVideo.startScreenshotBurst(1); }},
+		{"Every 2nd Frame", []() { emuVideo.startScreenshotBurst(2); }},
+		{"Every 4th Frame", []() { emuVideo.startScreenshotBurst(4); }},
+	},
+	screenshotBurst
+	{
+		"Screenshot Burst",
+		[]() -> int
+		{
+			switch(emuVideo.screenshotBurstInterval())
+			{
+				default: return 0;
+				case 1: return 1;
+				case 2: return 2;
+				case 4: return 3;
+			}
+		}(),
+		screenshotBurstItem
+	},
+	recordAV
+	{
+		"Record Video & Audio",
+		avCapture.isActive(),
+		[](BoolMenuItem &item, View &view, Input::Event e)
+		{
+			if(avCapture.isActive())
+			{
+				stopAVCapture();
+				item.setBoolValue(false, view);
+			}
+			else if(EmuSystem::gameIsRunning() && startAVCapture())
+			{
+				item.setBoolValue(true, view);
+			}
+		}
+	},
+	recordMovie
+	{
+		"Record Input Movie",
+		inputMovie.isRecording(),
+		[this](BoolMenuItem &item, View &view, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			if(inputMovie.isRecording())
+			{
+				auto frames = inputMovie.stop();
+				item.setBoolValue(false, view);
+				popup.printf(2, 0, "Recorded %u frames", frames);
+				onShow();
 			}
+			else if(EmuSystem::gameIsRunning())
+			{
+				if(auto err = inputMovie.startRecording(InputMovie::defaultPath().data());
+					err)
+				{
+					popup.printf(4, true, "Record Movie: %s", err->what());
+					return;
+				}
+				item.setBoolValue(true, view);
+				onShow();
+			}
+		}
+	},
+	playMovie
+	{
+		"Play Input Movie",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			inputMovie.stop();
+			if(auto err = inputMovie.startPlayback(InputMovie::defaultPath().data());
+				err)
+			{
+				popup.printf(4, true, "Play Movie: %s", err->what());
+				return;
+			}
+			startGameFromMenu();
+		}
+	},
+	benchmarkMovie
+	{
+		"Benchmark Input Movie",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			inputMovie.stop();
+			auto err = inputMovie.startBenchmark(InputMovie::defaultPath().data(),
+				[](EmuSystem::Error err, const InputMovie::BenchmarkResult &result)
+				{
+					if(err)
+					{
+						popup.printf(4, true, "Benchmark Movie: %s", err->what());
+					}
+					else
+					{
+						double fps = result.frames / (double)result.time;
+						if(!result.hasReference)
+							popup.printf(4, 0, "%.2f fps, %u frames\nVideo CRC %08X, saved as reference", fps, result.frames, (uint)result.crc);
+						else if(result.firstMismatch == -1)
+							popup.printf(4, 0, "%.2f fps, %u frames\nVideo CRC %08X matches reference", fps, result.frames, (uint)result.crc);
+						else
+							popup.printf(6, 1, "%.2f fps, %u frames\nVideo differs from reference at frame %d", fps, result.frames, result.firstMismatch);
+					}
+					// this view may have been dismissed while the benchmark ran
+					viewStack.top().onShow();
+				});
+			if(err)
+			{
+				popup.printf(4, true, "Benchmark Movie: %s", err->what());
+				return;
+			}
+			onShow();
+		}
+	},
+	netplay
+	{
+		"Netplay",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			auto &netplayMenu = *new NetplayView{attachParams()};
+			pushAndShow(netplayMenu, e);
+		}
+	},
+	memSearch
+	{
+		"RAM Search",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			auto &memSearchMenu = *new MemSearchView{attachParams()};
+			pushAndShow(memSearchMenu, e);
 		}
 	},
 	close
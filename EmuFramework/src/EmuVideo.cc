@@ -18,6 +18,8 @@
 #include <emuframework/EmuOptions.hh>
 #include <emuframework/EmuApp.hh>
 #include <emuframework/Screenshot.hh>
+#include <emuframework/AVCapture.hh>
+#include <emuframework/InputMovie.hh>
 #include "private.hh"
 
 void EmuVideo::resetImage()
@@ -72,10 +74,22 @@ EmuVideoImage EmuVideo::startFrame()
 
 void EmuVideo::writeFrame(Gfx::LockedTextureBuffer texBuff)
 {
+	if(unlikely(avCapture.isActive()))
+	{
+		avCapture.writeFrame(texBuff.pixmap());
+	}
+	if(unlikely(inputMovie.isCheckingVideo()))
+	{
+		inputMovie.addFrameCRC(texBuff.pixmap());
+	}
 	if(unlikely(screenshotNextFrame))
 	{
 		doScreenshot(texBuff.pixmap());
 	}
+	if(unlikely(burstInterval))
+	{
+		doBurstScreenshot(texBuff.pixmap());
+	}
 	vidImg.unlock(texBuff);
 	if(renderNextFrame)
 	{
@@ -86,10 +100,22 @@ void EmuVideo::writeFrame(Gfx::LockedTextureBuffer texBuff)
 
 void EmuVideo::writeFrame(IG::Pixmap pix)
 {
+	if(unlikely(avCapture.isActive()))
+	{
+		avCapture.writeFrame(pix);
+	}
+	if(unlikely(inputMovie.isCheckingVideo()))
+	{
+		inputMovie.addFrameCRC(pix);
+	}
 	if(screenshotNextFrame)
 	{
 		doScreenshot(pix);
 	}
+	if(burstInterval)
+	{
+		doBurstScreenshot(pix);
+	}
 	vidImg.write(0, pix, {}, vidImg.bestAlignment(pix));
 	if(renderNextFrame)
 	{
@@ -103,11 +129,48 @@ void EmuVideo::takeGameScreenshot()
 	screenshotNextFrame = true;
 }
 
+void EmuVideo::startScreenshotBurst(uint interval)
+{
+	assert(interval);
+	if(!burstInterval)
+	{
+		FS::PathString path;
+		burstNum = sprintScreenshotFilename(path);
+		if(burstNum == -1)
+		{
+			popup.postError("Too many screenshots");
+			return;
+		}
+		burstFrame = 0;
+		burstFrames = 0;
+		burstDropped = 0;
+		burstErrors = 0;
+	}
+	burstInterval = interval;
+}
+
+void EmuVideo::stopScreenshotBurst()
+{
+	if(!burstInterval)
+		return;
+	burstInterval = 0;
+	logMsg("screenshot burst #%d: %u frames, %u dropped, %u errors", burstNum, burstFrames, burstDropped, burstErrors);
+	if(burstDropped)
+		popup.printf(3, 0, "Wrote %u burst frames, dropped %u", burstFrames, burstDropped);
+	else
+		popup.printf(2, 0, "Wrote %u burst frames", burstFrames);
+}
+
 void EmuVideo::renderNextFrameToApp()
 {
 	renderNextFrame = true;
 }
 
+void EmuVideo::cancelRenderNextFrame()
+{
+	renderNextFrame = false;
+}
+
 void EmuVideo::doScreenshot(IG::Pixmap pix)
 {
 	screenshotNextFrame = false;
@@ -119,15 +182,47 @@ void EmuVideo::doScreenshot(IG::Pixmap pix)
 	}
 	else
 	{
-		if(!writeScreenshot(pix, path.data()))
+		auto onWrite =
+			[](int num, bool success)
+			{
+				if(!success)
+				{
+					popup.printf(2, 1, "Error writing screenshot #%d", num);
+				}
+				else
+				{
+					popup.printf(2, 0, "Wrote screenshot #%d", num);
+				}
+			};
+		if(!screenshotWriter.write(pix, path, screenshotNum, onWrite))
 		{
-			popup.printf(2, 1, "Error writing screenshot #%d", screenshotNum);
+			// all buffers are taken by a burst, write it directly
+			onWrite(screenshotNum, writeScreenshot(pix, path.data()));
 		}
-		else
+	}
+}
+
+void EmuVideo::doBurstScreenshot(IG::Pixmap pix)
+{
+	if(burstFrame++ % burstInterval)
+		return;
+	auto path = FS::makePathStringPrintf("%s/%s.%.3d.%.5u.png",
+		EmuSystem::savePath(), EmuSystem::gameName().data(), burstNum, burstFrames);
+	if(!screenshotWriter.write(pix, path, burstFrames,
+		[this](int num, bool success)
 		{
-			popup.printf(2, 0, "Wrote screenshot #%d", screenshotNum);
-		}
+			if(!success)
+			{
+				logErr("error writing burst frame %d", num);
+				burstErrors++;
+			}
+		}))
+	{
+		// encoder is behind, skip this frame rather than stall emulation
+		burstDropped++;
+		return;
 	}
+	burstFrames++;
 }
 
 bool EmuVideo::isExternalTexture()
@@ -156,6 +251,14 @@ void EmuVideoImage::endFrame()
 	}
 }
 
+void EmuVideoImage::cancelFrame()
+{
+	if(texBuff)
+	{
+		emuVideo->image().unlock(texBuff);
+	}
+}
+
 IG::WP EmuVideo::size() const
 {
 	if(!vidImg)
@@ -102,7 +102,7 @@ static FS::RootPathInfo nearestRootLocation(const char *path)
 	return {nearestPtr->root.name, nearestPtr->root.length};
 }
 
-EmuFilePicker *EmuFilePicker::makeForBenchmarking(ViewAttachParams attach, Input::Event e, bool singleDir)
+EmuFilePicker *EmuFilePicker::makeForBenchmarking(ViewAttachParams attach, Input::Event e, bool singleDir, bool withAVCapture)
 {
 	auto rootInfo = nearestRootLocation(lastLoadPath.data());
 	auto picker = new EmuFilePicker{attach, lastLoadPath.data(), false, EmuSystem::defaultBenchmarkFsFilter, rootInfo, e, singleDir};
@@ -112,12 +112,12 @@ EmuFilePicker *EmuFilePicker::makeForBenchmarking(ViewAttachParams attach, Input
 			lastLoadPath = picker.path();
 		});
 	picker->setOnSelectFile(
-		[](FSPicker &picker, const char* name, Input::Event e)
+		[withAVCapture](FSPicker &picker, const char* name, Input::Event e)
 		{
 			EmuApp::createSystemWithMedia({}, picker.makePathString(name).data(), "", e,
-				[](Input::Event e)
+				[withAVCapture](Input::Event e)
 				{
-					runBenchmarkOneShot();
+					runBenchmarkOneShot(withAVCapture);
 				});
 		});
 	return picker;
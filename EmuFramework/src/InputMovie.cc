@@ -0,0 +1,350 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "InputMovie"
+#include <emuframework/InputMovie.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/util/algorithm.h>
+#include <imagine/logger/logger.h>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+#include "private.hh"
+
+InputMovie inputMovie{};
+static constexpr uint BENCHMARK_SLICE_MSECS = 50;
+
+static const char movieMagic[8]{'E', 'M', 'U', 'M', 'O', 'V', '0', '1'};
+
+FS::PathString InputMovie::defaultPath()
+{
+	return FS::makePathStringPrintf("%s/%s.emumovie", EmuSystem::savePath(), EmuSystem::gameName().data());
+}
+
+EmuSystem::Error InputMovie::startRecording(const char *path)
+{
+	if(isActive())
+		return EmuSystem::makeError("Input movie already active");
+	if(!EmuSystem::gameIsRunning())
+		return EmuSystem::makeError("System not running");
+	// the save state anchors the recording, keep it in memory until the movie is written
+	auto statePath = FS::makePathStringPrintf("%s.state.tmp", path);
+	if(auto err = EmuSystem::saveState(statePath.data()))
+	{
+		FS::remove(statePath);
+		return err;
+	}
+	anchorStateSize = FS::file_size(statePath);
+	anchorState = std::make_unique<char[]>(anchorStateSize);
+	auto bytesRead = readFromFile(statePath.data(), anchorState.get(), anchorStateSize);
+	FS::remove(statePath);
+	if(bytesRead != (ssize_t)anchorStateSize)
+	{
+		anchorState.reset();
+		return EmuSystem::makeFileReadError();
+	}
+	// a benchmark reference from the movie being replaced no longer applies
+	FS::remove(FS::makePathStringPrintf("%s.crc", path));
+	string_copy(this->path, path);
+	event.clear();
+	frame = 0;
+	mode = Mode::RECORD;
+	logMsg("recording %s", path);
+	return {};
+}
+
+EmuSystem::Error InputMovie::startPlayback(const char *path)
+{
+	if(isActive())
+		return EmuSystem::makeError("Input movie already active");
+	if(!EmuSystem::gameIsRunning())
+		return EmuSystem::makeError("System not running");
+	FileIO file;
+	if(auto ec = file.open(path, IO::AccessHint::ALL))
+		return EmuSystem::makeError(ec);
+	char magic[sizeof(movieMagic)]{};
+	file.read(magic, sizeof(magic));
+	if(memcmp(magic, movieMagic, sizeof(magic)))
+		return EmuSystem::makeError("Not an input movie file");
+	std::error_code ec{};
+	auto movieFrames = file.readVal<uint32>(&ec);
+	auto events = file.readVal<uint32>(&ec);
+	auto movieStateSize = file.readVal<uint32>(&ec);
+	if(ec || movieStateSize > file.size() || events > file.size() / 10)
+		return EmuSystem::makeError("Input movie file is corrupt");
+	auto movieState = std::make_unique<char[]>(movieStateSize);
+	if(file.read(movieState.get(), movieStateSize) != (ssize_t)movieStateSize)
+		return EmuSystem::makeFileReadError();
+	event.resize(events);
+	for(auto &e : event)
+	{
+		e.frame = file.readVal<uint32>(&ec);
+		e.type = (EventType)file.readVal<uint8>(&ec);
+		e.state = file.readVal<uint8>(&ec);
+		e.emuKey = file.readVal<uint32>(&ec);
+	}
+	if(ec)
+	{
+		event.clear();
+		return EmuSystem::makeError("Input movie file is corrupt");
+	}
+	auto statePath = FS::makePathStringPrintf("%s.state.tmp", path);
+	if(auto ec = writeToNewFile(statePath.data(), movieState.get(), movieStateSize))
+	{
+		event.clear();
+		return EmuSystem::makeError(ec);
+	}
+	auto err = EmuSystem::loadState(statePath.data());
+	FS::remove(statePath);
+	if(err)
+	{
+		event.clear();
+		return err;
+	}
+	// any keys held before playback would otherwise stay pressed
+	EmuSystem::clearInputBuffers(emuInputView);
+	string_copy(this->path, path);
+	frames = movieFrames;
+	frame = 0;
+	nextEvent = 0;
+	mode = Mode::PLAY;
+	logMsg("playing %s, %u frames with %u events", path, frames, events);
+	return {};
+}
+
+uint InputMovie::stop()
+{
+	if(!isActive())
+		return 0;
+	if(isRecording())
+	{
+		frames = frame;
+		if(write())
+			logMsg("recorded %u frames with %u events", frames, (uint)event.size());
+	}
+	else
+	{
+		logMsg("stopped playback at frame %u", frame);
+	}
+	mode = Mode::OFF;
+	checkVideo = false;
+	event.clear();
+	event.shrink_to_fit();
+	anchorState.reset();
+	anchorStateSize = 0;
+	return frame;
+}
+
+bool InputMovie::write()
+{
+	FileIO file;
+	if(auto ec = file.create(path.data()))
+	{
+		logErr("error creating %s: %s", path.data(), ec.message().c_str());
+		return false;
+	}
+	std::error_code ec{};
+	file.write(movieMagic, sizeof(movieMagic));
+	file.writeVal<uint32>(frames, &ec);
+	file.writeVal<uint32>(event.size(), &ec);
+	file.writeVal<uint32>(anchorStateSize, &ec);
+	file.write(anchorState.get(), anchorStateSize);
+	for(auto &e : event)
+	{
+		file.writeVal<uint32>(e.frame, &ec);
+		file.writeVal<uint8>((uint8)e.type, &ec);
+		file.writeVal<uint8>(e.state, &ec);
+		file.writeVal<uint32>(e.emuKey, &ec);
+	}
+	if(ec)
+	{
+		logErr("error writing %s", path.data());
+		return false;
+	}
+	return true;
+}
+
+EmuSystem::Error InputMovie::startBenchmark(const char *path, BenchmarkDelegate onDone)
+{
+	if(auto err = startPlayback(path))
+		return err;
+	frameCRC.assign(frames, 0);
+	checkVideo = true;
+	benchmarkTime = {};
+	onBenchmarkDone = onDone;
+	benchmarkTimer.callbackAfterMSec(
+		[this]()
+		{
+			runBenchmarkSlice();
+		}, 1, 1, {});
+	return {};
+}
+
+void InputMovie::runBenchmarkSlice()
+{
+	if(!isPlaying() || !checkVideo)
+	{
+		// playback was stopped by a reset, state load, or the game closing
+		finishBenchmark(EmuSystem::makeError("Benchmark interrupted"));
+		return;
+	}
+	// keep each slice short enough to not stall the UI
+	auto startTime = IG::Time::now();
+	auto endTime = startTime + IG::Time::makeWithMSecs(BENCHMARK_SLICE_MSECS);
+	auto now = startTime;
+	while(frame < frames && now < endTime)
+	{
+		EmuSystem::runFrameWithCapture(&emuVideo, false);
+		now = IG::Time::now();
+	}
+	benchmarkTime += now - startTime;
+	if(frame < frames)
+	{
+		popup.printf(1, 0, "Benchmarking: %u/%u frames", frame, frames);
+		return;
+	}
+	finishBenchmark({});
+}
+
+void InputMovie::finishBenchmark(EmuSystem::Error err)
+{
+	benchmarkTimer.deinit();
+	auto onDone = onBenchmarkDone;
+	onBenchmarkDone = {};
+	BenchmarkResult result{};
+	if(!err)
+	{
+		result.time = benchmarkTime;
+		result.frames = frames;
+		result.crc = crc32(0, (const Bytef*)frameCRC.data(), frameCRC.size() * sizeof(uint32));
+		result.hasReference = checkBenchmarkReference(result);
+		logMsg("replayed %u frames in %.3fs, video CRC %08x", result.frames, (double)result.time, (uint)result.crc);
+	}
+	stop();
+	frameCRC.clear();
+	frameCRC.shrink_to_fit();
+	onDone(err, result);
+}
+
+bool InputMovie::checkBenchmarkReference(BenchmarkResult &result) const
+{
+	auto crcPath = FS::makePathStringPrintf("%s.crc", path.data());
+	if(!FS::exists(crcPath))
+	{
+		FileIO file;
+		if(!file.create(crcPath.data()))
+		{
+			for(auto crc : frameCRC)
+			{
+				char line[10];
+				snprintf(line, sizeof(line), "%08x\n", (uint)crc);
+				file.write(line, 9);
+			}
+		}
+		return false;
+	}
+	// one hex CRC per line from an earlier run
+	auto size = FS::file_size(crcPath);
+	auto text = std::make_unique<char[]>(size + 1);
+	auto bytesRead = readFromFile(crcPath.data(), text.get(), size);
+	text[std::max(bytesRead, (ssize_t)0)] = 0;
+	const char *pos = text.get();
+	iterateTimes(result.frames, i)
+	{
+		char *end;
+		auto refCRC = strtoul(pos, &end, 16);
+		if(end == pos || refCRC != frameCRC[i])
+		{
+			result.firstMismatch = i;
+			break;
+		}
+		pos = end;
+	}
+	return true;
+}
+
+void InputMovie::onFrame()
+{
+	if(isPlaying())
+	{
+		if(frame == frames)
+		{
+			stop();
+			popup.post("Input movie finished");
+			return;
+		}
+		for(; nextEvent < event.size() && event[nextEvent].frame <= frame; nextEvent++)
+		{
+			auto &e = event[nextEvent];
+			switch(e.type)
+			{
+				bcase EventType::INPUT: EmuSystem::handleInputAction(e.state, e.emuKey);
+				bcase EventType::CLEAR_INPUT: EmuSystem::clearInputBuffers(emuInputView);
+				bcase EventType::RESET_SOFT: EmuSystem::reset(EmuSystem::RESET_SOFT);
+				bcase EventType::RESET_HARD: EmuSystem::reset(EmuSystem::RESET_HARD);
+			}
+		}
+	}
+	frame++;
+}
+
+bool InputMovie::onInputAction(uint state, uint emuKey)
+{
+	if(isPlaying())
+		return false;
+	if(isRecording())
+		addEvent(EventType::INPUT, state, emuKey);
+	return true;
+}
+
+bool InputMovie::onClearInput()
+{
+	if(isPlaying())
+		return false;
+	if(isRecording())
+		addEvent(EventType::CLEAR_INPUT);
+	return true;
+}
+
+void InputMovie::onReset(EmuSystem::ResetMode resetMode)
+{
+	if(isPlaying())
+	{
+		// the user took over
+		stop();
+		return;
+	}
+	if(isRecording())
+		addEvent(resetMode == EmuSystem::RESET_SOFT ? EventType::RESET_SOFT : EventType::RESET_HARD);
+}
+
+void InputMovie::addFrameCRC(const IG::Pixmap &pix)
+{
+	uint idx = frame - 1;
+	if(idx >= frameCRC.size())
+		return;
+	auto rowBytes = pix.format().pixelBytes(pix.w());
+	uLong crc = crc32(0, nullptr, 0);
+	iterateTimes(pix.h(), y)
+	{
+		crc = crc32(crc, (const Bytef*)pix.pixel({0, (int)y}), rowBytes);
+	}
+	frameCRC[idx] = crc;
+}
+
+void InputMovie::addEvent(EventType type, uint state, uint emuKey)
+{
+	event.push_back({frame, type, (uint8)state, emuKey});
+}
@@ -0,0 +1,274 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "MemSearch"
+#include <emuframework/MemSearch.hh>
+#include <imagine/util/algorithm.h>
+#include <imagine/util/bits.h>
+#include <imagine/logger/logger.h>
+#include <cstring>
+
+#if defined __GNUC__ && !defined MEMSEARCH_NO_SIMD
+#define MEMSEARCH_SIMD
+#endif
+
+MemSearch memSearch{};
+
+// candidates are tracked 64 positions per bitset word
+static constexpr uint BLOCK = 64;
+
+template <class T>
+static T loadValue(const uint8 *data, size_t pos, bool rotate)
+{
+	T val;
+	memcpy(&val, &data[pos * sizeof(T)], sizeof(T));
+	if(sizeof(T) == 4 && rotate)
+		val = (val << 16) | (val >> 16);
+	return val;
+}
+
+template <class T>
+static bool compareValue(T val, T operand, MemSearch::Compare compare)
+{
+	switch(compare)
+	{
+		case MemSearch::Compare::EQUAL: return val == operand;
+		case MemSearch::Compare::NOT_EQUAL: return val != operand;
+		case MemSearch::Compare::GREATER: return val > operand;
+		case MemSearch::Compare::LESS: return val < operand;
+	}
+	return false;
+}
+
+template <class T>
+static uint64 filterBlockScalar(const uint8 *data, const uint8 *prev, size_t pos, uint count,
+	MemSearch::Filter f, bool rotate)
+{
+	uint64 bits = 0;
+	iterateTimes(count, i)
+	{
+		T val = loadValue<T>(data, pos + i, rotate);
+		T operand = f.withPrevious ? loadValue<T>(prev, pos + i, rotate) : (T)f.value;
+		bits |= (uint64)compareValue(val, operand, f.compare) << i;
+	}
+	return bits;
+}
+
+#ifdef MEMSEARCH_SIMD
+template <class T>
+static uint64 filterBlock(const uint8 *data, const uint8 *prev, size_t pos,
+	MemSearch::Filter f, bool rotate)
+{
+	typedef T Vec __attribute__((vector_size(16)));
+	static constexpr uint lanes = 16 / sizeof(T);
+	static constexpr uint lanesPerWord = lanes / 2;
+	// each lane's compare result is masked to its bit, then the bits of the
+	// lanes in each 64-bit half are summed with a multiply
+	static constexpr uint64 sumMul = sizeof(T) == 1 ? 0x0101010101010101ull :
+		sizeof(T) == 2 ? 0x0001000100010001ull : 0x0000000100000001ull;
+	Vec weight;
+	iterateTimes(lanes, i)
+	{
+		weight[i] = 1 << (i % lanesPerWord);
+	}
+	Vec operand = (Vec){} + (T)f.value;
+	uint64 bits = 0;
+	data += pos * sizeof(T);
+	prev += pos * sizeof(T);
+	for(uint i = 0; i < BLOCK; i += lanes)
+	{
+		Vec val;
+		memcpy(&val, &data[i * sizeof(T)], sizeof(Vec));
+		if(f.withPrevious)
+			memcpy(&operand, &prev[i * sizeof(T)], sizeof(Vec));
+		if(sizeof(T) == 4 && rotate)
+		{
+			val = (val << 16) | (val >> 16);
+			if(f.withPrevious)
+				operand = (operand << 16) | (operand >> 16);
+		}
+		Vec match;
+		switch(f.compare)
+		{
+			case MemSearch::Compare::EQUAL: match = (Vec)(val == operand); break;
+			case MemSearch::Compare::NOT_EQUAL: match = (Vec)(val != operand); break;
+			case MemSearch::Compare::GREATER: match = (Vec)(val > operand); break;
+			case MemSearch::Compare::LESS: match = (Vec)(val < operand); break;
+		}
+		match &= weight;
+		uint64 half[2];
+		memcpy(half, &match, sizeof(half));
+		uint64 laneBits = ((half[0] * sumMul) >> (64 - sizeof(T) * 8)) |
+			(((half[1] * sumMul) >> (64 - sizeof(T) * 8)) << lanesPerWord);
+		bits |= laneBits << i;
+	}
+	return bits;
+}
+#else
+template <class T>
+static uint64 filterBlock(const uint8 *data, const uint8 *prev, size_t pos,
+	MemSearch::Filter f, bool rotate)
+{
+	return filterBlockScalar<T>(data, prev, pos, BLOCK, f, rotate);
+}
+#endif
+
+template <class T>
+static uint filterRegion(const uint8 *data, uint8 *prev, uint64 *candidate, size_t positions,
+	MemSearch::Filter f, bool rotate)
+{
+	uint count = 0;
+	size_t blocks = positions / BLOCK;
+	iterateTimes(blocks, b)
+	{
+		// most of RAM gets ruled out by the first filters
+		if(!candidate[b])
+			continue;
+		size_t pos = b * BLOCK;
+		candidate[b] &= filterBlock<T>(data, prev, pos, f, rotate);
+		memcpy(&prev[pos * sizeof(T)], &data[pos * sizeof(T)], BLOCK * sizeof(T));
+		count += IG::bitsSet((unsigned long long)candidate[b]);
+	}
+	if(uint tail = positions % BLOCK;
+		tail && candidate[blocks])
+	{
+		size_t pos = blocks * BLOCK;
+		candidate[blocks] &= filterBlockScalar<T>(data, prev, pos, tail, f, rotate);
+		memcpy(&prev[pos * sizeof(T)], &data[pos * sizeof(T)], tail * sizeof(T));
+		count += IG::bitsSet((unsigned long long)candidate[blocks]);
+	}
+	return count;
+}
+
+bool MemSearch::start(Width width)
+{
+	stop();
+	EmuSystem::MemSearchRegion coreRegion[EmuSystem::MAX_MEM_SEARCH_REGIONS]{};
+	uint coreRegions = EmuSystem::memSearchRegions(coreRegion);
+	if(!coreRegions)
+		return false;
+	width_ = width;
+	candidates_ = 0;
+	filtered = false;
+	iterateTimes(coreRegions, i)
+	{
+		auto &r = region[regions];
+		auto &c = coreRegion[i];
+		r.positions = c.size / widthBytes(width);
+		if(!r.positions)
+			continue;
+		r.data = (uint8*)c.data;
+		r.size = c.size;
+		r.address = c.address;
+		r.wordSwapped = c.wordSwapped;
+		r.prev = std::make_unique<uint8[]>(r.size);
+		memcpy(r.prev.get(), r.data, r.size);
+		size_t words = (r.positions + BLOCK - 1) / BLOCK;
+		r.candidate = std::make_unique<uint64[]>(words);
+		std::fill_n(r.candidate.get(), words, ~0ull);
+		if(auto tail = r.positions % BLOCK)
+			r.candidate[words - 1] = (1ull << tail) - 1;
+		candidates_ += r.positions;
+		regions++;
+	}
+	logMsg("started %u-bit search over %u regions, %u candidates", widthBytes(width) * 8, regions, candidates_);
+	return regions;
+}
+
+void MemSearch::stop()
+{
+	iterateTimes(regions, i)
+	{
+		region[i] = {};
+	}
+	regions = 0;
+	candidates_ = 0;
+	live = false;
+}
+
+uint MemSearch::filter(Filter f)
+{
+	if(!isActive())
+		return 0;
+	auto startTime = IG::Time::now();
+	uint count = 0;
+	iterateTimes(regions, i)
+	{
+		auto &r = region[i];
+		bool rotate = r.wordSwapped;
+		switch(width_)
+		{
+			bcase Width::BITS_8:
+				count += filterRegion<uint8>(r.data, r.prev.get(), r.candidate.get(), r.positions, f, rotate);
+			bcase Width::BITS_16:
+				count += filterRegion<uint16>(r.data, r.prev.get(), r.candidate.get(), r.positions, f, rotate);
+			bcase Width::BITS_32:
+				count += filterRegion<uint32>(r.data, r.prev.get(), r.candidate.get(), r.positions, f, rotate);
+		}
+	}
+	filterTime = IG::Time::now() - startTime;
+	candidates_ = count;
+	lastFilter = f;
+	filtered = true;
+	if(!count)
+		live = false;
+	return count;
+}
+
+uint32 MemSearch::readValue(const Region &r, const uint8 *data, size_t pos) const
+{
+	switch(width_)
+	{
+		case Width::BITS_8: return loadValue<uint8>(data, pos, false);
+		case Width::BITS_16: return loadValue<uint16>(data, pos, false);
+		case Width::BITS_32: return loadValue<uint32>(data, pos, r.wordSwapped);
+	}
+	return 0;
+}
+
+uint MemSearch::results(Result *result, uint max) const
+{
+	uint count = 0;
+	iterateTimes(regions, i)
+	{
+		auto &r = region[i];
+		size_t words = (r.positions + BLOCK - 1) / BLOCK;
+		iterateTimes(words, w)
+		{
+			for(auto bits = r.candidate[w]; bits; bits &= bits - 1)
+			{
+				if(count == max)
+					return count;
+				size_t pos = w * BLOCK + IG::ctz((unsigned long long)bits);
+				uint32 offset = pos * widthBytes(width_);
+				// byte addresses of word swapped RAM have the low bit flipped
+				if(r.wordSwapped && width_ == Width::BITS_8)
+					offset ^= 1;
+				result[count++] = {r.address + offset, readValue(r, r.data, pos)};
+			}
+		}
+	}
+	return count;
+}
+
+void MemSearch::setLive(bool on)
+{
+	live = on && filtered && candidates_;
+}
+
+void MemSearch::onFrame()
+{
+	filter(lastFilter);
+}
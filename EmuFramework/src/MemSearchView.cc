@@ -0,0 +1,239 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/MemSearchView.hh>
+#include <emuframework/EmuApp.hh>
+#include <cstdlib>
+#include <vector>
+#include <array>
+#include "private.hh"
+
+static MemSearch::Width searchWidth = MemSearch::Width::BITS_8;
+static constexpr uint MAX_RESULTS = 100;
+
+class MemSearchResultsView : public TableView
+{
+public:
+	MemSearchResultsView(ViewAttachParams attach):
+		TableView
+		{
+			"RAM Search Results",
+			attach,
+			[this](const TableView &)
+			{
+				return result.size();
+			},
+			[this](const TableView &, uint idx) -> MenuItem&
+			{
+				return result[idx];
+			}
+		}
+	{
+		MemSearch::Result res[MAX_RESULTS];
+		uint count = memSearch.results(res, MAX_RESULTS);
+		uint digits = MemSearch::widthBytes(memSearch.width()) * 2;
+		text.resize(count);
+		result.reserve(count);
+		iterateTimes(count, i)
+		{
+			string_printf(text[i], "%06X: %u (0x%0*X)", res[i].address, res[i].value, digits, res[i].value);
+			result.emplace_back(text[i].data(), [](){});
+		}
+	}
+
+private:
+	std::vector<std::array<char, 40>> text{};
+	std::vector<TextMenuItem> result{};
+};
+
+MemSearchView::MemSearchView(ViewAttachParams attach):
+	TableView{"RAM Search", attach, item},
+	widthItem
+	{
+		{"8-bit", []() { searchWidth = MemSearch::Width::BITS_8; }},
+		{"16-bit", []() { searchWidth = MemSearch::Width::BITS_16; }},
+		{"32-bit", []() { searchWidth = MemSearch::Width::BITS_32; }},
+	},
+	width
+	{
+		"Value Size",
+		(int)searchWidth,
+		widthItem
+	},
+	newSearch
+	{
+		"New Search",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!memSearch.start(searchWidth))
+			{
+				popup.postError("No searchable RAM in this system");
+				return;
+			}
+			popup.printf(2, 0, "Searching %u values", memSearch.candidates());
+			updateResultsText();
+			onShow();
+		}
+	},
+	equal
+	{
+		"Equal To Value",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(item.active())
+				pushValueInput(e, MemSearch::Compare::EQUAL);
+		}
+	},
+	greater
+	{
+		"Greater Than Value",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(item.active())
+				pushValueInput(e, MemSearch::Compare::GREATER);
+		}
+	},
+	less
+	{
+		"Less Than Value",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(item.active())
+				pushValueInput(e, MemSearch::Compare::LESS);
+		}
+	},
+	changed
+	{
+		"Changed",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(item.active())
+				runFilter({MemSearch::Compare::NOT_EQUAL, true});
+		}
+	},
+	unchanged
+	{
+		"Unchanged",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(item.active())
+				runFilter({MemSearch::Compare::EQUAL, true});
+		}
+	},
+	increased
+	{
+		"Increased",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(item.active())
+				runFilter({MemSearch::Compare::GREATER, true});
+		}
+	},
+	decreased
+	{
+		"Decreased",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(item.active())
+				runFilter({MemSearch::Compare::LESS, true});
+		}
+	},
+	live
+	{
+		"Live Search",
+		memSearch.isLive(),
+		[this](BoolMenuItem &item, View &view, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			memSearch.setLive(item.flipBoolValue(view));
+		}
+	},
+	results
+	{
+		resultsText,
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			auto &resultsView = *new MemSearchResultsView{attachParams()};
+			pushAndShow(resultsView, e);
+		}
+	}
+{
+	updateResultsText();
+	item.emplace_back(&width);
+	item.emplace_back(&newSearch);
+	item.emplace_back(&equal);
+	item.emplace_back(&greater);
+	item.emplace_back(&less);
+	item.emplace_back(&changed);
+	item.emplace_back(&unchanged);
+	item.emplace_back(&increased);
+	item.emplace_back(&decreased);
+	item.emplace_back(&live);
+	item.emplace_back(&results);
+}
+
+void MemSearchView::onShow()
+{
+	bool searching = memSearch.isActive() && memSearch.candidates();
+	equal.setActive(searching);
+	greater.setActive(searching);
+	less.setActive(searching);
+	changed.setActive(searching);
+	unchanged.setActive(searching);
+	increased.setActive(searching);
+	decreased.setActive(searching);
+	live.setActive(searching && memSearch.hasFiltered());
+	live.setBoolValue(memSearch.isLive());
+	updateResultsText();
+	results.setActive(searching);
+}
+
+void MemSearchView::pushValueInput(Input::Event e, MemSearch::Compare compare)
+{
+	EmuApp::pushAndShowNewCollectTextInputView(attachParams(), e, "Input decimal or 0x hex value", "",
+		[this, compare](CollectTextInputView &view, const char *str)
+		{
+			if(str)
+			{
+				char *end;
+				auto value = strtoull(str, &end, 0);
+				uint64 max = (1ull << (MemSearch::widthBytes(memSearch.width()) * 8)) - 1;
+				if(end == str || *end || value > max)
+				{
+					popup.postError("Invalid value for this size");
+					return 1;
+				}
+				runFilter({compare, false, (uint32)value});
+			}
+			view.dismiss();
+			return 0;
+		});
+}
+
+void MemSearchView::runFilter(MemSearch::Filter filter)
+{
+	uint count = memSearch.filter(filter);
+	popup.printf(2, 0, "%u values left (%.3fms)", count, (double)memSearch.lastFilterTime() * 1000.);
+	onShow();
+}
+
+void MemSearchView::updateResultsText()
+{
+	string_printf(resultsText, "Results (%u)", memSearch.candidates());
+	results.compile(renderer(), projP);
+}
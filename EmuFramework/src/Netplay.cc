@@ -0,0 +1,742 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "Netplay"
+#include <emuframework/Netplay.hh>
+#include <emuframework/InputMovie.hh>
+#include <imagine/util/algorithm.h>
+#include <imagine/util/string.h>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "private.hh"
+#include "privateInput.hh"
+
+Netplay netplay{};
+
+// packets start with 'E', 'N', protocol version, type
+//   HELLO: game name, null terminated
+//   WELCOME, BYE: no data
+//   INPUT: uint32 ack (remote frames received), uint32 first frame, uint8 frame count,
+//     per frame: uint8 event count, per event: uint8 state, uint32 emu key
+static constexpr uint8 PROTOCOL_VERSION = 1;
+static constexpr uint8 PACKET_HELLO = 'H';
+static constexpr uint8 PACKET_WELCOME = 'W';
+static constexpr uint8 PACKET_INPUT = 'I';
+static constexpr uint8 PACKET_BYE = 'B';
+static constexpr uint HEADER_SIZE = 4;
+static constexpr uint MAX_PACKET_SIZE = 1200;
+static constexpr double TIMEOUT_SECS = 5.;
+static constexpr double HELLO_INTERVAL_SECS = .5;
+static constexpr int KEEPALIVE_INTERVAL_MSECS = 250;
+static constexpr uint BENCHMARK_SLICE_MSECS = 50;
+
+static uint writePacketHeader(uint8 *data, uint8 type)
+{
+	data[0] = 'E';
+	data[1] = 'N';
+	data[2] = PROTOCOL_VERSION;
+	data[3] = type;
+	return HEADER_SIZE;
+}
+
+static void write32(uint8 *data, uint &pos, uint32 val)
+{
+	memcpy(&data[pos], &val, 4);
+	pos += 4;
+}
+
+static uint32 read32(const uint8 *data, uint &pos)
+{
+	uint32 val;
+	memcpy(&val, &data[pos], 4);
+	pos += 4;
+	return val;
+}
+
+EmuSystem::Error Netplay::startSession(Mode mode)
+{
+	if(isActive())
+		return EmuSystem::makeError("Netplay already active");
+	if(!EmuSystem::gameIsRunning())
+		return EmuSystem::makeError("System not running");
+	if(inputMovie.isActive())
+		return EmuSystem::makeError("Stop the input movie first");
+	snapshotSize = EmuSystem::stateMemSize();
+	if(!snapshotSize)
+		return EmuSystem::makeError("Not supported by this emulator");
+	snapshot = std::make_unique<char[]>(snapshotSize * SNAPSHOTS);
+	this->mode = mode;
+	connected = false;
+	stats_ = {};
+	lastReceiveTime = IG::Time::now();
+	// sessions are usually started from the menu with emulation paused
+	if(!EmuSystem::isActive())
+		startKeepAlive();
+	logMsg("started session with %zu byte states", snapshotSize);
+	return {};
+}
+
+EmuSystem::Error Netplay::host(uint port)
+{
+	if(auto err = startSession(Mode::HOST))
+		return err;
+	localPlayer = 0;
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if(sock == -1)
+	{
+		auto err = EmuSystem::makeError(std::error_code{errno, std::system_category()});
+		stop();
+		return err;
+	}
+	fcntl(sock, F_SETFL, O_NONBLOCK);
+	sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	if(bind(sock, (sockaddr*)&addr, sizeof(addr)) == -1)
+	{
+		auto err = EmuSystem::makeError(std::error_code{errno, std::system_category()});
+		stop();
+		return err;
+	}
+	logMsg("waiting for player 2 on port %u", port);
+	return {};
+}
+
+EmuSystem::Error Netplay::join(const char *address)
+{
+	char hostStr[256];
+	string_copy(hostStr, address);
+	char portStr[8];
+	string_printf(portStr, "%u", DEFAULT_PORT);
+	if(auto portPos = strrchr(hostStr, ':'))
+	{
+		*portPos = 0;
+		string_copy(portStr, portPos + 1);
+	}
+	if(auto err = startSession(Mode::JOIN))
+		return err;
+	localPlayer = 1;
+	addrinfo hints{};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+	addrinfo *res{};
+	if(auto ret = getaddrinfo(hostStr, portStr, &hints, &res);
+		ret || !res)
+	{
+		stop();
+		return EmuSystem::makeError("Can't resolve %s: %s", hostStr, gai_strerror(ret));
+	}
+	peerAddrLen = std::min((uint)res->ai_addrlen, (uint)sizeof(peerAddr));
+	memcpy(peerAddr, res->ai_addr, peerAddrLen);
+	freeaddrinfo(res);
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if(sock == -1)
+	{
+		auto err = EmuSystem::makeError(std::error_code{errno, std::system_category()});
+		stop();
+		return err;
+	}
+	fcntl(sock, F_SETFL, O_NONBLOCK);
+	sendHello(PACKET_HELLO);
+	logMsg("joining %s:%s", hostStr, portStr);
+	return {};
+}
+
+EmuSystem::Error Netplay::startLoopback(LoopbackConfig config)
+{
+	if(auto err = startSession(Mode::LOOPBACK))
+		return err;
+	localPlayer = 0;
+	loopback = config;
+	loopback.latency = std::min(loopback.latency, LOOPBACK_PACKETS / 2);
+	loopback.jitter = std::min(loopback.jitter, LOOPBACK_PACKETS / 4);
+	tick = 0;
+	loopbackFrames = 0;
+	loopbackLocalFrames = 0;
+	loopbackEchoFrames = 0;
+	randState = 1;
+	std::fill_n(loopbackInput, HISTORY, FrameInput{});
+	std::fill_n(loopbackPacket, LOOPBACK_PACKETS, LoopbackPacket{});
+	std::fill_n(sentFrames, LOOPBACK_PACKETS, 0);
+	loopbackPackets = 0;
+	loopbackHeld = 0;
+	localRandomHeld = 0;
+	// the user's game is put back as it was when the test stops
+	loopbackStartState = std::make_unique<char[]>(snapshotSize);
+	if(!EmuSystem::saveStateMem(loopbackStartState.get(), snapshotSize))
+	{
+		loopbackStartState.reset();
+		stop();
+		return EmuSystem::makeError("Error saving state");
+	}
+	logMsg("loopback with %u frames latency, %u jitter, %u%% loss", loopback.latency, loopback.jitter, loopback.lossPercent);
+	beginGame();
+	return {};
+}
+
+EmuSystem::Error Netplay::startLoopbackBenchmark(LoopbackConfig config, uint frames, BenchmarkDelegate onDone)
+{
+	config.randomInput = true;
+	if(auto err = startLoopback(config))
+		return err;
+	benchmarkFrames = frames;
+	benchmarkTime = {};
+	onBenchmarkDone = onDone;
+	benchmarkTimer.callbackAfterMSec(
+		[this]()
+		{
+			runBenchmarkSlice();
+		}, 1, 1, {});
+	return {};
+}
+
+void Netplay::runBenchmarkSlice()
+{
+	if(!isLoopback())
+	{
+		// stopped by the user, an error, or the game closing
+		finishBenchmark(EmuSystem::makeError("Benchmark interrupted"));
+		return;
+	}
+	// keep each slice short enough to not stall the UI
+	auto startTime = IG::Time::now();
+	auto endTime = startTime + IG::Time::makeWithMSecs(BENCHMARK_SLICE_MSECS);
+	auto now = startTime;
+	while(stats_.frames < benchmarkFrames && isActive() && now < endTime)
+	{
+		if(rand() % 8 == 0)
+			toggleRandomDirection(localRandomHeld, localPlayer, nullptr);
+		// frames are only written to the texture, never presented from here
+		emuVideo.cancelRenderNextFrame();
+		EmuSystem::runFrameWithCapture(&emuVideo, false);
+		now = IG::Time::now();
+	}
+	benchmarkTime += now - startTime;
+	if(!isActive())
+	{
+		finishBenchmark(EmuSystem::makeError("Benchmark interrupted"));
+		return;
+	}
+	if(stats_.frames < benchmarkFrames)
+	{
+		popup.printf(1, 0, "Benchmarking: %u/%u frames", stats_.frames, benchmarkFrames);
+		return;
+	}
+	finishBenchmark({});
+}
+
+void Netplay::finishBenchmark(EmuSystem::Error err)
+{
+	benchmarkTimer.deinit();
+	auto onDone = onBenchmarkDone;
+	onBenchmarkDone = {};
+	auto stats = stats_;
+	stop();
+	onDone(err, stats, benchmarkTime);
+}
+
+void Netplay::stop()
+{
+	if(!isActive())
+		return;
+	if(sock != -1)
+	{
+		if(connected)
+		{
+			uint8 data[HEADER_SIZE];
+			sendPacket(data, writePacketHeader(data, PACKET_BYE));
+		}
+		close(sock);
+		sock = -1;
+	}
+	logMsg("stopped after %u frames, %u stalls, %u rollbacks (max %u frames), %u frames re-run in %.3fs, %.3fs saving states",
+		stats_.frames, stats_.stalls, stats_.rollbacks, stats_.maxRollback, stats_.resimFrames,
+		(double)stats_.resimTime, (double)stats_.saveTime);
+	keepAliveTimer.deinit();
+	if(loopbackStartState)
+	{
+		if(EmuSystem::gameIsRunning() && !EmuSystem::loadStateMem(loopbackStartState.get(), snapshotSize))
+			logErr("error restoring state from before loopback");
+		loopbackStartState.reset();
+	}
+	mode = Mode::OFF;
+	connected = false;
+	peerAddrLen = 0;
+	snapshot.reset();
+	snapshotSize = 0;
+	heldKeys = 0;
+	// the remote player's keys would otherwise stay held
+	if(EmuSystem::gameIsRunning())
+		EmuSystem::clearInputBuffers(emuInputView);
+}
+
+void Netplay::end(const char *msg)
+{
+	logErr("%s", msg);
+	popup.postError(msg);
+	stop();
+}
+
+void Netplay::beginGame()
+{
+	connected = true;
+	frame = 0;
+	remoteFrames = 0;
+	remoteAck = 0;
+	rollbackFrame = ~0u;
+	for(auto &playerInput : input)
+	{
+		std::fill_n(playerInput, HISTORY, FrameInput{});
+	}
+	heldKeys = 0;
+	lastReceiveTime = IG::Time::now();
+	// both sides start from the same state, the simulated peer shares ours
+	if(!isLoopback())
+		EmuSystem::reset(EmuSystem::RESET_HARD);
+	EmuSystem::clearInputBuffers(emuInputView);
+	logMsg("started game as player %u", localPlayer + 1);
+	if(!isLoopback())
+		popup.printf(2, 0, "Netplay started as player %u", localPlayer + 1);
+}
+
+bool Netplay::prepareFrame()
+{
+	if(isLoopback())
+	{
+		sentFrames[tick % LOOPBACK_PACKETS] = frame;
+		tick++;
+		runLoopbackPeer();
+		pollLoopback();
+	}
+	else
+	{
+		poll();
+	}
+	if(!isActive())
+		return true;
+	if(!connected)
+		return false;
+	if(rollbackFrame < frame)
+	{
+		rollback();
+		if(!isActive())
+			return true;
+	}
+	// don't get further ahead than a rollback can cover
+	if((int)(frame - remoteFrames) >= (int)MAX_ROLLBACK || frame - remoteAck >= HISTORY - 1)
+	{
+		stats_.stalls++;
+		if(!isLoopback())
+			sendInput();
+		return false;
+	}
+	saveSnapshot(frame);
+	if(!isActive())
+		return true;
+	applyInput(frame);
+	return true;
+}
+
+void Netplay::finishFrame()
+{
+	frame++;
+	stats_.frames++;
+	frameInput(localPlayer, frame) = {};
+	if(!isLoopback())
+		sendInput();
+}
+
+void Netplay::onLocalInputAction(uint state, uint emuKey)
+{
+	emuKey = EmuSystem::inputActionForPlayer(emuKey, localPlayer);
+	auto heldEnd = heldKey + heldKeys;
+	auto held = std::find(heldKey, heldEnd, emuKey);
+	if(state == Input::PUSHED)
+	{
+		if(held == heldEnd && heldKeys < MAX_HELD_KEYS)
+			heldKey[heldKeys++] = emuKey;
+	}
+	else if(held != heldEnd)
+	{
+		*held = heldKey[--heldKeys];
+	}
+	auto &in = frameInput(localPlayer, frame);
+	if(in.events == MAX_FRAME_EVENTS)
+	{
+		logWarn("too many events in frame %u", frame);
+		return;
+	}
+	in.event[in.events++] = {emuKey, (uint8)state};
+}
+
+void Netplay::releaseLocalInput()
+{
+	while(heldKeys)
+	{
+		onLocalInputAction(Input::RELEASED, heldKey[heldKeys - 1]);
+	}
+}
+
+void Netplay::startKeepAlive()
+{
+	if(!isActive() || isLoopback())
+		return;
+	keepAliveTimer.callbackAfterMSec(
+		[this]()
+		{
+			// the other side stalls once it's MAX_ROLLBACK frames ahead,
+			// but both keep receiving packets so the session survives the pause
+			poll();
+			if(connected)
+				sendInput();
+		}, KEEPALIVE_INTERVAL_MSECS, KEEPALIVE_INTERVAL_MSECS, {});
+}
+
+void Netplay::stopKeepAlive()
+{
+	keepAliveTimer.deinit();
+}
+
+void Netplay::saveSnapshot(uint frame)
+{
+	auto startTime = IG::Time::now();
+	if(!EmuSystem::saveStateMem(snapshotData(frame), snapshotSize))
+	{
+		end("Netplay error saving state");
+		return;
+	}
+	stats_.saveTime += IG::Time::now() - startTime;
+}
+
+void Netplay::applyInput(uint frame)
+{
+	iterateTimes(2, player)
+	{
+		// remote input that hasn't arrived is predicted to not change
+		if(player != localPlayer && frame >= remoteFrames)
+			continue;
+		auto &in = frameInput(player, frame);
+		iterateTimes(in.events, i)
+		{
+			EmuSystem::handleInputAction(in.event[i].state, in.event[i].emuKey);
+		}
+	}
+}
+
+void Netplay::rollback()
+{
+	auto startTime = IG::Time::now();
+	uint startFrame = rollbackFrame;
+	rollbackFrame = ~0u;
+	assumeExpr(frame - startFrame <= MAX_ROLLBACK);
+	if(!EmuSystem::loadStateMem(snapshotData(startFrame), snapshotSize))
+	{
+		end("Netplay error loading state");
+		return;
+	}
+	for(uint f = startFrame; f < frame; f++)
+	{
+		if(f != startFrame)
+		{
+			saveSnapshot(f);
+			if(!isActive())
+				return;
+		}
+		applyInput(f);
+		EmuSystem::runFrame(nullptr, false);
+	}
+	uint depth = frame - startFrame;
+	stats_.rollbacks++;
+	stats_.resimFrames += depth;
+	stats_.maxRollback = std::max(stats_.maxRollback, depth);
+	stats_.resimTime += IG::Time::now() - startTime;
+}
+
+void Netplay::storeRemoteInput(uint frame, const FrameInput &in)
+{
+	if(frame != remoteFrames)
+		return;
+	// keep the input of frames a rollback may still need
+	if((int)(frame + MAX_ROLLBACK - this->frame) >= (int)HISTORY)
+		return;
+	frameInput(localPlayer ^ 1, frame) = in;
+	remoteFrames++;
+	if(in.events && frame < this->frame)
+	{
+		// already ran with a wrong prediction
+		rollbackFrame = std::min(rollbackFrame, frame);
+	}
+}
+
+void Netplay::poll()
+{
+	auto now = IG::Time::now();
+	for(;;)
+	{
+		uint8 data[MAX_PACKET_SIZE];
+		sockaddr_in from{};
+		socklen_t fromLen = sizeof(from);
+		auto size = recvfrom(sock, data, sizeof(data), 0, (sockaddr*)&from, &fromLen);
+		if(size < 0)
+			break;
+		if(mode == Mode::HOST && !connected)
+		{
+			// accept the first player that says hello
+			peerAddrLen = std::min((uint)fromLen, (uint)sizeof(peerAddr));
+			memcpy(peerAddr, &from, peerAddrLen);
+		}
+		else
+		{
+			auto &peer = *(sockaddr_in*)peerAddr;
+			if(from.sin_addr.s_addr != peer.sin_addr.s_addr || from.sin_port != peer.sin_port)
+				continue;
+		}
+		lastReceiveTime = now;
+		stats_.packetsReceived++;
+		receivePacket(data, size);
+		if(!isActive())
+			return;
+	}
+	if(mode == Mode::JOIN && !connected)
+	{
+		if(now - lastReceiveTime > IG::Time::makeWithSecs(TIMEOUT_SECS))
+		{
+			end("No response from netplay host");
+			return;
+		}
+		if(now - lastHelloTime > IG::Time::makeWithSecs(HELLO_INTERVAL_SECS))
+			sendHello(PACKET_HELLO);
+	}
+	else if(connected && now - lastReceiveTime > IG::Time::makeWithSecs(TIMEOUT_SECS))
+	{
+		end("Netplay connection lost");
+	}
+}
+
+void Netplay::receivePacket(const uint8 *data, uint size)
+{
+	if(size < HEADER_SIZE || data[0] != 'E' || data[1] != 'N' || data[2] != PROTOCOL_VERSION)
+	{
+		logWarn("ignoring invalid packet");
+		return;
+	}
+	switch(data[3])
+	{
+		bcase PACKET_HELLO:
+		{
+			if(mode != Mode::HOST)
+				return;
+			if(connected)
+			{
+				// our welcome got lost
+				sendHello(PACKET_WELCOME);
+				return;
+			}
+			auto name = (const char*)&data[HEADER_SIZE];
+			if(strnlen(name, size - HEADER_SIZE) == size - HEADER_SIZE ||
+				!string_equal(name, EmuSystem::gameName().data()))
+			{
+				logMsg("player joined with a different game");
+				uint8 bye[HEADER_SIZE];
+				sendPacket(bye, writePacketHeader(bye, PACKET_BYE));
+				peerAddrLen = 0;
+				return;
+			}
+			sendHello(PACKET_WELCOME);
+			beginGame();
+		}
+		bcase PACKET_WELCOME:
+		{
+			if(mode == Mode::JOIN && !connected)
+				beginGame();
+		}
+		bcase PACKET_BYE:
+		{
+			end(connected ? "Other player left netplay" : "Netplay host refused the connection");
+		}
+		bcase PACKET_INPUT:
+		{
+			if(!connected || size < HEADER_SIZE + 9)
+				return;
+			uint pos = HEADER_SIZE;
+			uint ack = read32(data, pos);
+			uint firstFrame = read32(data, pos);
+			uint frames = data[pos++];
+			if(ack > remoteAck && ack <= frame)
+				remoteAck = ack;
+			iterateTimes(frames, i)
+			{
+				if(pos >= size)
+					return;
+				FrameInput in;
+				in.events = data[pos++];
+				if(in.events > MAX_FRAME_EVENTS || pos + in.events * 5 > size)
+					return;
+				iterateTimes(in.events, e)
+				{
+					in.event[e].state = data[pos++];
+					in.event[e].emuKey = read32(data, pos);
+				}
+				storeRemoteInput(firstFrame + i, in);
+			}
+		}
+	}
+}
+
+void Netplay::sendInput()
+{
+	// every packet repeats the input the remote hasn't acknowledged, so lost ones need no resend
+	uint8 data[MAX_PACKET_SIZE];
+	uint pos = writePacketHeader(data, PACKET_INPUT);
+	write32(data, pos, remoteFrames);
+	write32(data, pos, remoteAck);
+	uint framesPos = pos++;
+	uint frames = 0;
+	for(uint f = remoteAck; f < frame; f++)
+	{
+		auto &in = frameInput(localPlayer, f);
+		if(pos + 1 + in.events * 5 > sizeof(data))
+			break;
+		data[pos++] = in.events;
+		iterateTimes(in.events, i)
+		{
+			data[pos++] = in.event[i].state;
+			write32(data, pos, in.event[i].emuKey);
+		}
+		frames++;
+	}
+	data[framesPos] = frames;
+	sendPacket(data, pos);
+}
+
+void Netplay::sendPacket(const uint8 *data, uint size)
+{
+	if(!peerAddrLen)
+		return;
+	if(sendto(sock, data, size, 0, (sockaddr*)peerAddr, peerAddrLen) == -1)
+	{
+		logWarn("error sending packet: %s", strerror(errno));
+		return;
+	}
+	stats_.packetsSent++;
+}
+
+void Netplay::sendHello(uint8 type)
+{
+	uint8 data[HEADER_SIZE + sizeof(FS::FileString)];
+	uint pos = writePacketHeader(data, type);
+	if(type == PACKET_HELLO)
+	{
+		auto name = EmuSystem::gameName();
+		auto nameSize = strlen(name.data()) + 1;
+		memcpy(&data[pos], name.data(), nameSize);
+		pos += nameSize;
+	}
+	sendPacket(data, pos);
+	lastHelloTime = IG::Time::now();
+}
+
+void Netplay::runLoopbackPeer()
+{
+	// the simulated peer receives our input after the latency
+	if(tick > loopback.latency)
+		loopbackLocalFrames = sentFrames[(tick - loopback.latency) % LOOPBACK_PACKETS];
+	// and stalls like we do
+	if((int)(loopbackFrames - loopbackLocalFrames) < (int)MAX_ROLLBACK &&
+		loopbackFrames - remoteFrames < HISTORY - 1)
+	{
+		auto &in = loopbackInput[loopbackFrames % HISTORY];
+		in = {};
+		if(loopback.randomInput)
+		{
+			if(rand() % 8 == 0)
+				toggleRandomDirection(loopbackHeld, localPlayer ^ 1, &in);
+		}
+		else
+		{
+			// mirror the local player's input as it arrives
+			for(; loopbackEchoFrames < loopbackLocalFrames; loopbackEchoFrames++)
+			{
+				auto &localIn = frameInput(localPlayer, loopbackEchoFrames);
+				iterateTimes(localIn.events, i)
+				{
+					if(in.events == MAX_FRAME_EVENTS)
+						break;
+					in.event[in.events++] = {EmuSystem::inputActionForPlayer(localIn.event[i].emuKey, localPlayer ^ 1), localIn.event[i].state};
+				}
+			}
+		}
+		loopbackFrames++;
+	}
+	// each tick it sends all its input, some packets arrive late or never
+	if(loopback.lossPercent && rand() % 100 < loopback.lossPercent)
+		return;
+	auto &packet = loopbackPacket[loopbackPackets++ % LOOPBACK_PACKETS];
+	packet.deliverTick = tick + loopback.latency + (loopback.jitter ? rand() % (loopback.jitter + 1) : 0);
+	packet.frames = loopbackFrames;
+	packet.localFrames = loopbackLocalFrames;
+	packet.pending = true;
+}
+
+void Netplay::pollLoopback()
+{
+	for(auto &packet : loopbackPacket)
+	{
+		if(!packet.pending || packet.deliverTick > tick)
+			continue;
+		packet.pending = false;
+		stats_.packetsReceived++;
+		remoteAck = std::max(remoteAck, std::min(packet.localFrames, frame));
+		for(uint f = remoteFrames; f < packet.frames; f++)
+		{
+			storeRemoteInput(f, loopbackInput[f % HISTORY]);
+		}
+	}
+}
+
+uint32 Netplay::rand()
+{
+	// xorshift, so loopback runs repeat exactly
+	randState ^= randState << 13;
+	randState ^= randState >> 17;
+	randState ^= randState << 5;
+	return randState;
+}
+
+void Netplay::toggleRandomDirection(uint32 &held, uint player, FrameInput *in)
+{
+	uint dir = rand() % 4;
+	uint32 bit = 1 << dir;
+	uint state = (held & bit) ? Input::RELEASED : Input::PUSHED;
+	held ^= bit;
+	// the first 4 keys of every system are the directions
+	auto emuKey = EmuSystem::translateInputAction(EmuControls::systemKeyMapStart + dir);
+	if(!in)
+	{
+		onLocalInputAction(state, emuKey);
+		return;
+	}
+	if(in->events < MAX_FRAME_EVENTS)
+		in->event[in->events++] = {EmuSystem::inputActionForPlayer(emuKey, player), (uint8)state};
+}
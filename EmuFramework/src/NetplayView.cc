@@ -0,0 +1,215 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/NetplayView.hh>
+#include <emuframework/Netplay.hh>
+#include <emuframework/EmuApp.hh>
+#include "private.hh"
+
+static uint loopbackLatency = 4;
+static uint loopbackJitter = 0;
+static uint loopbackLossPercent = 0;
+static constexpr uint BENCHMARK_FRAMES = 3600;
+
+NetplayView::NetplayView(ViewAttachParams attach):
+	TableView{"Netplay", attach, item},
+	host
+	{
+		"Host Game",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			if(auto err = netplay.host();
+				err)
+			{
+				popup.printf(4, true, "Host Game: %s", err->what());
+				return;
+			}
+			popup.printf(4, 0, "Waiting for player 2 on port %u", Netplay::DEFAULT_PORT);
+			startGameFromMenu();
+		}
+	},
+	join
+	{
+		"Join Game",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			EmuApp::pushAndShowNewCollectTextInputView(attachParams(), e, "Host address", "",
+				[](CollectTextInputView &view, const char *str)
+				{
+					if(str && strlen(str))
+					{
+						if(auto err = netplay.join(str);
+							err)
+						{
+							popup.printf(4, true, "Join Game: %s", err->what());
+							return 1;
+						}
+						view.dismiss();
+						startGameFromMenu();
+						return 0;
+					}
+					view.dismiss();
+					return 0;
+				});
+		}
+	},
+	loopback
+	{
+		"Loopback Test",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			Netplay::LoopbackConfig config{};
+			config.latency = loopbackLatency;
+			config.jitter = loopbackJitter;
+			config.lossPercent = loopbackLossPercent;
+			if(auto err = netplay.startLoopback(config);
+				err)
+			{
+				popup.printf(4, true, "Loopback Test: %s", err->what());
+				return;
+			}
+			popup.printf(3, 0, "Player 2 mirrors your input %u frames late", loopbackLatency * 2);
+			startGameFromMenu();
+		}
+	},
+	latencyItem
+	{
+		{"2", []() { loopbackLatency = 2; }},
+		{"4", []() { loopbackLatency = 4; }},
+		{"8", []() { loopbackLatency = 8; }},
+	},
+	latency
+	{
+		"Loopback Latency (Frames)",
+		[]() -> int
+		{
+			switch(loopbackLatency)
+			{
+				case 2: return 0;
+				default: return 1;
+				case 8: return 2;
+			}
+		}(),
+		latencyItem
+	},
+	jitterItem
+	{
+		{"0", []() { loopbackJitter = 0; }},
+		{"1", []() { loopbackJitter = 1; }},
+		{"2", []() { loopbackJitter = 2; }},
+	},
+	jitter
+	{
+		"Loopback Jitter (Frames)",
+		(int)loopbackJitter,
+		jitterItem
+	},
+	lossItem
+	{
+		{"0%", []() { loopbackLossPercent = 0; }},
+		{"5%", []() { loopbackLossPercent = 5; }},
+		{"10%", []() { loopbackLossPercent = 10; }},
+		{"25%", []() { loopbackLossPercent = 25; }},
+	},
+	loss
+	{
+		"Loopback Packet Loss",
+		[]() -> int
+		{
+			switch(loopbackLossPercent)
+			{
+				default: return 0;
+				case 5: return 1;
+				case 10: return 2;
+				case 25: return 3;
+			}
+		}(),
+		lossItem
+	},
+	benchmark
+	{
+		"Loopback Benchmark",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			Netplay::LoopbackConfig config{};
+			config.latency = loopbackLatency;
+			config.jitter = loopbackJitter;
+			config.lossPercent = loopbackLossPercent;
+			auto err = netplay.startLoopbackBenchmark(config, BENCHMARK_FRAMES,
+				[](EmuSystem::Error err, const Netplay::Stats &stats, IG::Time time)
+				{
+					if(err)
+					{
+						popup.printf(4, true, "Loopback Benchmark: %s", err->what());
+					}
+					else
+					{
+						double fps = stats.frames / (double)time;
+						double avgDepth = stats.rollbacks ? stats.resimFrames / (double)stats.rollbacks : 0.;
+						double resimMSecs = stats.resimFrames ? (double)stats.resimTime * 1000. / stats.resimFrames : 0.;
+						popup.printf(6, 0, "%.2f fps, %u rollbacks\nDepth %.1f avg, %u max\n%.3fms per re-run frame",
+							fps, stats.rollbacks, avgDepth, stats.maxRollback, resimMSecs);
+					}
+					// this view may have been dismissed while the benchmark ran
+					viewStack.top().onShow();
+				});
+			if(err)
+			{
+				popup.printf(4, true, "Loopback Benchmark: %s", err->what());
+				return;
+			}
+			onShow();
+		}
+	},
+	disconnect
+	{
+		"Disconnect",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active())
+				return;
+			netplay.stop();
+			popup.post("Netplay stopped");
+			onShow();
+		}
+	}
+{
+	item.emplace_back(&host);
+	item.emplace_back(&join);
+	item.emplace_back(&loopback);
+	item.emplace_back(&latency);
+	item.emplace_back(&jitter);
+	item.emplace_back(&loss);
+	item.emplace_back(&benchmark);
+	item.emplace_back(&disconnect);
+}
+
+void NetplayView::onShow()
+{
+	bool canStart = EmuSystem::gameIsRunning() && !netplay.isActive();
+	host.setActive(canStart);
+	join.setActive(canStart);
+	loopback.setActive(canStart);
+	benchmark.setActive(canStart);
+	disconnect.setActive(netplay.isActive());
+}
@@ -17,6 +17,7 @@
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuOptions.hh>
 #include <emuframework/FilePicker.hh>
+#include <emuframework/BackupMemFlusher.hh>
 #include <imagine/gui/TextEntry.hh>
 #include <algorithm>
 #include "private.hh"
@@ -402,12 +403,30 @@ static void printFrameRatePALStr(char (&str)[S])
 		1. / EmuSystem::frameTime(EmuSystem::VIDSYS_PAL));
 }
 
+template <size_t S>
+static void printFrameStatsStr(char (&str)[S])
+{
+	auto &stats = EmuSystem::frameStats;
+	string_printf(str, "Frames: %u run, %u shown, %u skipped",
+		stats.emulated, stats.displayed, stats.skipped);
+}
+
+void VideoOptionView::onShow()
+{
+	printFrameStatsStr(frameStatsStr);
+	frameStats.compile(renderer(), projP);
+}
+
 void VideoOptionView::loadStockItems()
 {
 	#if defined CONFIG_BASE_SCREEN_FRAME_INTERVAL
 	item.emplace_back(&frameInterval);
 	#endif
 	item.emplace_back(&dropLateFrames);
+	item.emplace_back(&autoFrameSkip);
+	item.emplace_back(&minDisplayFps);
+	printFrameStatsStr(frameStatsStr);
+	item.emplace_back(&frameStats);
 	if(!optionFrameRate.isConst)
 	{
 		printFrameRateStr(frameRateStr);
@@ -443,6 +462,10 @@ void VideoOptionView::loadStockItems()
 	#ifdef CONFIG_GFX_OPENGL_SHADER_PIPELINE
 	item.emplace_back(&imgEffectPixelFormat);
 	#endif
+	if(!optionVideoFilterThreads.isConst)
+	{
+		item.emplace_back(&videoFilterThreads);
+	}
 	#ifdef EMU_FRAMEWORK_WINDOW_PIXEL_FORMAT_OPTION
 	item.emplace_back(&windowPixelFormat);
 	#endif
@@ -497,6 +520,20 @@ void AudioOptionView::updateAudioRateItem()
 	}
 }
 
+template <size_t S>
+static void printBackupMemStatsStr(char (&str)[S])
+{
+	auto stats = backupMemFlusher.stats();
+	string_printf(str, "Save RAM: %u writes, %uKB, max %.1fms",
+		stats.writes, (uint)(stats.bytesWritten / 1024), (double)stats.maxWriteTime * 1000.);
+}
+
+void SystemOptionView::onShow()
+{
+	printBackupMemStatsStr(backupMemStatsStr);
+	backupMemStats.compile(renderer(), projP);
+}
+
 void SystemOptionView::loadStockItems()
 {
 	item.emplace_back(&autoSaveState);
@@ -505,6 +542,8 @@ void SystemOptionView::loadStockItems()
 	printPathMenuEntryStr(optionSavePath, savePathStr);
 	item.emplace_back(&savePath);
 	item.emplace_back(&checkSavePathWriteAccess);
+	printBackupMemStatsStr(backupMemStatsStr);
+	item.emplace_back(&backupMemStats);
 	item.emplace_back(&fastForwardSpeed);
 	#ifdef __ANDROID__
 	item.emplace_back(&processPriority);
@@ -689,6 +728,49 @@ VideoOptionView::VideoOptionView(ViewAttachParams attach, bool customMenu):
 			optionSkipLateFrames.val = item.flipBoolValue(*this);
 		}
 	},
+	autoFrameSkip
+	{
+		"Auto Frame Skip",
+		(bool)optionAutoFrameSkip,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionAutoFrameSkip.val = item.flipBoolValue(*this);
+		}
+	},
+	minDisplayFpsItem
+	{
+		{"10", [this]() { optionMinDisplayFps = 10; }},
+		{"15", [this]() { optionMinDisplayFps = 15; }},
+		{"20", [this]() { optionMinDisplayFps = 20; }},
+		{"30", [this]() { optionMinDisplayFps = 30; }},
+	},
+	minDisplayFps
+	{
+		"Min Displayed Frame Rate",
+		[]() -> int
+		{
+			switch(optionMinDisplayFps)
+			{
+				case 10: return 0;
+				default: return 1;
+				case 20: return 2;
+				case 30: return 3;
+			}
+		}(),
+		minDisplayFpsItem
+	},
+	frameStats
+	{
+		frameStatsStr,
+		[this](TextMenuItem &, View &, Input::Event e)
+		{
+			// counts cover the whole game session until reset here
+			EmuSystem::frameStats = {};
+			printFrameStatsStr(frameStatsStr);
+			frameStats.compile(renderer(), projP);
+			postDraw();
+		}
+	},
 	frameRate
 	{
 		frameRateStr,
@@ -891,6 +973,19 @@ VideoOptionView::VideoOptionView(ViewAttachParams attach, bool customMenu):
 		imgEffectPixelFormatItem
 	},
 	#endif
+	videoFilterThreadsItem
+	{
+		{"1", [this]() { optionVideoFilterThreads = 1; }},
+		{"2", [this]() { optionVideoFilterThreads = 2; }},
+		{"3", [this]() { optionVideoFilterThreads = 3; }},
+		{"4", [this]() { optionVideoFilterThreads = 4; }},
+	},
+	videoFilterThreads
+	{
+		"Video Filter Threads",
+		optionVideoFilterThreads - 1,
+		videoFilterThreadsItem
+	},
 	#ifdef EMU_FRAMEWORK_WINDOW_PIXEL_FORMAT_OPTION
 	windowPixelFormatItem
 	{
@@ -1261,6 +1356,16 @@ SystemOptionView::SystemOptionView(ViewAttachParams attach, bool customMenu):
 			optionCheckSavePathWriteAccess = item.flipBoolValue(*this);
 		}
 	},
+	backupMemStats
+	{
+		backupMemStatsStr,
+		[this](TextMenuItem &, View &, Input::Event e)
+		{
+			printBackupMemStatsStr(backupMemStatsStr);
+			backupMemStats.compile(renderer(), projP);
+			postDraw();
+		}
+	},
 	fastForwardSpeedItem
 	{
 		{"3x", [this]() { optionFastForwardSpeed = 2; }},
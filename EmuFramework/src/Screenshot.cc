@@ -19,7 +19,9 @@
 #include <imagine/data-type/image/sys.hh>
 #include <imagine/pixmap/Pixmap.hh>
 #include <imagine/io/FileIO.hh>
+#include <imagine/thread/Thread.hh>
 #include <imagine/mem/mem.h>
+#include <algorithm>
 
 #ifdef CONFIG_DATA_TYPE_IMAGE_QUARTZ2D
 
@@ -54,18 +56,37 @@ bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 namespace Base
 {
 
-JNIEnv* jEnv(); // JNIEnv of main event thread
+extern JavaVM *jVM;
 extern jclass jBaseActivityCls;
 extern jobject jBaseActivity;
 
 }
 
+// may run on ScreenshotWriter's thread, which stays attached to the VM once used
+static JNIEnv *threadJEnv()
+{
+	using namespace Base;
+	JNIEnv *env;
+	if(jVM->GetEnv((void**)&env, JNI_VERSION_1_6) != JNI_OK)
+	{
+		logMsg("attaching screenshot thread to JNI");
+		if(jVM->AttachCurrentThread(&env, nullptr) != 0)
+		{
+			logErr("error attaching env to thread");
+			return nullptr;
+		}
+	}
+	return env;
+}
+
 bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 {
 	static JavaInstMethod<jobject(jint, jint, jint)> jMakeBitmap;
 	static JavaInstMethod<jboolean(jobject, jobject)> jWritePNG;
 	using namespace Base;
-	auto env = jEnv();
+	auto env = threadJEnv();
+	if(!env)
+		return false;
 	if(!jMakeBitmap)
 	{
 		jMakeBitmap.setup(env, jBaseActivityCls, "makeBitmap", "(III)Landroid/graphics/Bitmap;");
@@ -197,14 +218,95 @@ bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 
 #endif
 
+ScreenshotWriter screenshotWriter{};
+
+bool ScreenshotWriter::write(const IG::Pixmap &pix, FS::PathString path, int num, OnWriteDelegate onWrite)
+{
+	auto freeJob = std::find_if(std::begin(job), std::end(job), [](const Job &j){ return !j.busy; });
+	if(freeJob == std::end(job))
+	{
+		logMsg("no free screenshot buffers");
+		return false;
+	}
+	if(!workerRunning)
+		startWorker();
+	auto &j = *freeJob;
+	if((IG::PixmapDesc)j.pix != (IG::PixmapDesc)pix)
+	{
+		j.pix = {(IG::PixmapDesc)pix};
+	}
+	j.pix.write(pix, {});
+	j.path = path;
+	j.onWrite = onWrite;
+	j.num = num;
+	j.busy = true;
+	{
+		std::lock_guard<std::mutex> lock{queueMutex};
+		queue[(queueStart + queueSize) % BUFFERS] = freeJob - std::begin(job);
+		queueSize++;
+	}
+	workerStart.notify();
+	return true;
+}
+
+uint ScreenshotWriter::pending() const
+{
+	return std::count_if(std::begin(job), std::end(job), [](const Job &j){ return j.busy; });
+}
+
+void ScreenshotWriter::startWorker()
+{
+	workerRunning = true;
+	donePipe.init({},
+		[this](Base::Pipe &pipe)
+		{
+			while(pipe.hasData())
+			{
+				DoneMessage msg;
+				if(!pipe.read(&msg, sizeof(msg)))
+					break;
+				onJobDone(msg);
+			}
+			return 1;
+		});
+	IG::makeDetachedThread(
+		[this]()
+		{
+			for(;;)
+			{
+				workerStart.wait();
+				uint8 idx;
+				{
+					std::lock_guard<std::mutex> lock{queueMutex};
+					idx = queue[queueStart];
+					queueStart = (queueStart + 1) % BUFFERS;
+					queueSize--;
+				}
+				auto &j = job[idx];
+				DoneMessage msg{idx, writeScreenshot(j.pix, j.path.data())};
+				donePipe.write(&msg, sizeof(msg));
+			}
+		});
+}
+
+void ScreenshotWriter::onJobDone(DoneMessage msg)
+{
+	auto &j = job[msg.idx];
+	j.busy = false;
+	if(j.onWrite)
+		j.onWrite(j.num, msg.success);
+}
+
 int sprintScreenshotFilename(FS::PathString &str)
 {
 	const uint maxNum = 999;
 	int num = -1;
 	iterateTimes(maxNum, i)
 	{
+		// also skip numbers used by a screenshot burst
+		auto burstStr = FS::makePathStringPrintf("%s/%s.%.3d.00000.png", EmuSystem::savePath(), EmuSystem::gameName().data(), i);
 		string_printf(str, "%s/%s.%.3d.png", EmuSystem::savePath(), EmuSystem::gameName().data(), i);
-		if(!FS::exists(str))
+		if(!FS::exists(str) && !FS::exists(burstStr))
 		{
 			num = i;
 			break;
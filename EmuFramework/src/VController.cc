@@ -280,11 +280,11 @@ bool VControllerKeyboard::keyInput(VController &v, Gfx::Renderer &r, Input::Even
 		}
 		else if(e.pushed())
 		{
-			EmuSystem::handleInputAction(Input::PUSHED, currentKey());
+			EmuSystem::sendInputAction(Input::PUSHED, currentKey());
 		}
 		else
 		{
-			EmuSystem::handleInputAction(Input::RELEASED, currentKey());
+			EmuSystem::sendInputAction(Input::RELEASED, currentKey());
 		}
 		return true;
 	}
@@ -940,7 +940,7 @@ void VController::inputAction(uint action, uint vBtn)
 {
 	if(isInKeyboardMode())
 	{
-		EmuSystem::handleInputAction(action, kb.translateInput(vBtn));
+		EmuSystem::sendInputAction(action, kb.translateInput(vBtn));
 	}
 	else
 	{
@@ -958,7 +958,7 @@ void VController::inputAction(uint action, uint vBtn)
 				turboActions.removeEvent(keyCode);
 			}
 		}
-		EmuSystem::handleInputAction(action, keyCode);
+		EmuSystem::sendInputAction(action, keyCode);
 	}
 }
 
@@ -0,0 +1,68 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "VideoFilterThreads"
+#include <emuframework/VideoFilterThreads.hh>
+#include <imagine/thread/Thread.hh>
+#include <imagine/util/algorithm.h>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+
+VideoFilterThreads videoFilterThreads{};
+
+void VideoFilterThreads::runBand(uint idx)
+{
+	uint startRow = rows * idx / bands;
+	uint endRow = rows * (idx + 1) / bands;
+	band(startRow, endRow);
+}
+
+void VideoFilterThreads::run(uint rows, uint threads, BandDelegate band)
+{
+	threads = std::min(std::clamp(threads, 1u, MAX_THREADS), rows);
+	if(threads <= 1)
+	{
+		band(0, rows);
+		return;
+	}
+	this->band = band;
+	this->rows = rows;
+	bands = threads;
+	iterateTimes(threads - 1, i)
+	{
+		auto &w = worker[i];
+		if(!w.running)
+		{
+			logMsg("starting filter thread %u", i);
+			w.running = true;
+			IG::makeDetachedThread(
+				[this, i]()
+				{
+					for(;;)
+					{
+						worker[i].start.wait();
+						runBand(i + 1);
+						done.notify();
+					}
+				});
+		}
+		w.start.notify();
+	}
+	runBand(0);
+	iterateTimes(threads - 1, i)
+	{
+		done.wait();
+	}
+}
@@ -86,7 +86,7 @@ bool showAutoStateConfirm(Gfx::Renderer &r, Input::Event e, bool addToRecent);
 void onMainMenuItemOptionChanged();
 void placeEmuViews();
 void placeElements();
-void runBenchmarkOneShot();
+void runBenchmarkOneShot(bool withAVCapture = false);
 void onSelectFileFromPicker(Gfx::Renderer &r, const char* name, Input::Event e);
 void startGameFromMenu();
 void closeGame(bool allowAutosaveState = true);
@@ -16,12 +16,15 @@
 #define LOGTAG "main"
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuAppInlines.hh>
+#include <emuframework/BackupMemFlusher.hh>
 #include "internal.hh"
 #include "Cheats.hh"
 #include <vbam/gba/GBA.h>
 #include <vbam/gba/GBAGfx.h>
 #include <vbam/gba/Sound.h>
 #include <vbam/gba/RTC.h>
+#include <vbam/gba/EEprom.h>
+#include <vbam/gba/Flash.h>
 #include <vbam/common/SoundDriver.h>
 #include <vbam/common/Patch.h>
 #include <vbam/Util.h>
@@ -108,6 +111,15 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 		return makeFileReadError();
 }
 
+uint EmuSystem::memSearchRegions(MemSearchRegion (&region)[MAX_MEM_SEARCH_REGIONS])
+{
+	if(!gameIsRunning())
+		return 0;
+	region[0] = {gGba.mem.workRAM, sizeof(gGba.mem.workRAM), 0x02000000, false};
+	region[1] = {gGba.mem.internalRAM, sizeof(gGba.mem.internalRAM), 0x03000000, false};
+	return 2;
+}
+
 void EmuSystem::saveBackupMem()
 {
 	if(gameIsRunning())
@@ -115,11 +127,35 @@ void EmuSystem::saveBackupMem()
 		logMsg("saving backup memory");
 		auto saveStr = FS::makePathStringPrintf("%s/%s.sav", savePath(), gameName().data());
 		fixFilePermissions(saveStr);
-		CPUWriteBatteryFile(gGba, saveStr.data());
+		if(!backupMemFlusher.flush())
+			CPUWriteBatteryFile(gGba, saveStr.data());
 		writeCheatFile();
 	}
 }
 
+uint EmuSystem::backupMemRegions(BackupMemRegion (&region)[MAX_BACKUP_MEM_REGIONS])
+{
+	if(!gameIsRunning())
+		return 0;
+	// same save type selection as CPUWriteBatteryFile()
+	int type = gbaSaveType;
+	if(!type)
+	{
+		if(eepromInUse)
+			type = 3;
+		else if(saveType == 1 || saveType == 2)
+			type = saveType;
+	}
+	if(!type || type == 5)
+		return 0;
+	auto saveStr = FS::makePathStringPrintf("%s/%s.sav", savePath(), gameName().data());
+	if(type == 3)
+		region[0] = {eepromData, (size_t)eepromSize, saveStr};
+	else
+		region[0] = {flashSaveMemory, type == 2 ? (size_t)flashSize : 0x10000, saveStr};
+	return 1;
+}
+
 void EmuSystem::closeSystem()
 {
 	assert(gameIsRunning());
@@ -1000,6 +1000,7 @@ static inline u32 CPUReadMemoryQuick(ARM7TDMI &cpu, u32 addr)
 	{ return READ32LE(((u32*)&cpu.map[addr>>24].address[addr & cpu.map[addr>>24].mask])); }
 
 extern void (*cpuSaveGameFunc)(u32,u8);
+extern int gbaSaveType;
 
 #ifdef BKPT_SUPPORT
 extern u8 freezeWorkRAM[0x40000];
@@ -24,6 +24,7 @@
 #include "loadres.h"
 #include "file/file.h"
 #include <cstddef>
+#include <ctime>
 #include <string>
 #include <imagine/util/DelegateFunc.hh>
 
@@ -119,6 +120,21 @@ public:
 	/** Writes persistent cartridge data to disk. Done implicitly on ROM close. */
 	void saveSavedata();
 
+	/**
+	  * Returns the battery-backed cartridge RAM that saveSavedata() writes to the .sav file
+	  * and sets size to its length, or returns 0 if none is present.
+	  */
+	unsigned char const * savedata(std::size_t &size) const;
+
+	/**
+	  * Sets baseTime to the clock value that saveSavedata() writes to the .rtc file.
+	  * @return false if the cartridge has no real-time clock
+	  */
+	bool rtcBaseTime(std::time_t &baseTime) const;
+
+	/** Returns the path, minus extension, of the .sav and .rtc files. */
+	std::string const saveBasePath() const;
+
 	/**
 	  * Saves emulator state to the state slot selected with selectState().
 	  * The data will be stored in the directory given by setSaveDir().
@@ -32,6 +32,8 @@ public:
 	void loadState(SaveState const &state);
 	void loadSavedata() { mem_.loadSavedata(); }
 	void saveSavedata() { mem_.saveSavedata(); }
+	unsigned char const * savedata(std::size_t &size) const { return mem_.savedata(size); }
+	bool rtcBaseTime(std::time_t &baseTime) const { return mem_.rtcBaseTime(baseTime); }
 
 	void setVideoBuffer(PixelType *videoBuf, std::ptrdiff_t pitch) {
 		mem_.setVideoBuffer(videoBuf, pitch);
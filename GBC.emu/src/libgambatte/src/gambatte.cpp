@@ -133,6 +133,21 @@ void GB::saveSavedata() {
 		p_->cpu.saveSavedata();
 }
 
+unsigned char const * GB::savedata(std::size_t &size) const {
+	if (!p_->cpu.loaded())
+		return 0;
+
+	return p_->cpu.savedata(size);
+}
+
+bool GB::rtcBaseTime(std::time_t &baseTime) const {
+	return p_->cpu.loaded() && p_->cpu.rtcBaseTime(baseTime);
+}
+
+std::string const GB::saveBasePath() const {
+	return p_->cpu.saveBasePath();
+}
+
 void GB::setDmgPaletteColor(int palNum, int colorNum, unsigned long rgb32) {
 	p_->cpu.setDmgPaletteColor(palNum, colorNum, rgb32);
 }
@@ -708,6 +708,22 @@ void Cartridge::saveSavedata() {
 	}
 }
 
+unsigned char const * Cartridge::savedata(std::size_t &size) const {
+	if (!hasBattery(memptrs_.romdata()[0x147]))
+		return 0;
+
+	size = memptrs_.rambankdataend() - memptrs_.rambankdata();
+	return memptrs_.rambankdata();
+}
+
+bool Cartridge::rtcBaseTime(std::time_t &baseTime) const {
+	if (!hasRtc(memptrs_.romdata()[0x147]))
+		return false;
+
+	baseTime = rtc_.baseTime();
+	return true;
+}
+
 static int asHex(char c) {
 	return c >= 'A' ? c - 'A' + 0xA : c - '0';
 }
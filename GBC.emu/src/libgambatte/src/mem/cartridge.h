@@ -64,6 +64,8 @@ public:
 	unsigned char rtcRead() const { return *rtc_.activeData(); }
 	void loadSavedata();
 	void saveSavedata();
+	unsigned char const * savedata(std::size_t &size) const;
+	bool rtcBaseTime(std::time_t &baseTime) const;
 	std::string const saveBasePath() const;
 	void setSaveDir(std::string const &dir);
 	LoadRes loadROM(const void *romdata, std::size_t size, std::string const &romfilename, bool forceDmg, bool multicartCompat);
@@ -43,6 +43,8 @@ public:
 	void loadState(SaveState const &state);
 	void loadSavedata() { cart_.loadSavedata(); }
 	void saveSavedata() { cart_.saveSavedata(); }
+	unsigned char const * savedata(std::size_t &size) const { return cart_.savedata(size); }
+	bool rtcBaseTime(std::time_t &baseTime) const { return cart_.rtcBaseTime(baseTime); }
 	std::string const saveBasePath() const { return cart_.saveBasePath(); }
 
 #ifndef GAMBATTE_NO_OSD
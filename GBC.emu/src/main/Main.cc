@@ -16,6 +16,7 @@
 #define LOGTAG "main"
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuAppInlines.hh>
+#include <emuframework/BackupMemFlusher.hh>
 #include <gambatte.h>
 #include <resample/resampler.h>
 #include <resample/resamplerinfo.h>
@@ -119,11 +120,37 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 void EmuSystem::saveBackupMem()
 {
 	logMsg("saving battery");
-	gbEmu.saveSavedata();
+	if(!backupMemFlusher.flush())
+		gbEmu.saveSavedata();
 
 	writeCheatFile();
 }
 
+uint EmuSystem::backupMemRegions(BackupMemRegion (&region)[MAX_BACKUP_MEM_REGIONS])
+{
+	if(!gameIsRunning())
+		return 0;
+	auto basePath = gbEmu.saveBasePath();
+	uint regions = 0;
+	size_t size;
+	if(auto data = gbEmu.savedata(size))
+	{
+		region[regions++] = {data, size, FS::makePathStringPrintf("%s.sav", basePath.c_str())};
+	}
+	std::time_t baseTime;
+	if(gbEmu.rtcBaseTime(baseTime))
+	{
+		// same big-endian layout gambatte writes to the .rtc file
+		static uint8 rtcData[4];
+		rtcData[0] = baseTime >> 24;
+		rtcData[1] = baseTime >> 16;
+		rtcData[2] = baseTime >> 8;
+		rtcData[3] = baseTime;
+		region[regions++] = {rtcData, sizeof(rtcData), FS::makePathStringPrintf("%s.rtc", basePath.c_str())};
+	}
+	return regions;
+}
+
 void EmuSystem::savePathChanged()
 {
 	if(gameIsRunning())
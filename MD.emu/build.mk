@@ -43,6 +43,9 @@ endif
 
 gplusSrc += z80/z80.cc
 
+gplusSrc += ntsc/md_ntsc.cc \
+ntsc/sms_ntsc.cc
+
 gplusSrc += sound/sound.cc \
 sound/ym2612.cc \
 sound/Fir_Resampler.cc \
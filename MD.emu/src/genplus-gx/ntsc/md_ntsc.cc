@@ -87,78 +87,65 @@ void md_ntsc_init( md_ntsc_t* ntsc, md_ntsc_setup_t const* setup )
 }
 
 #ifndef MD_NTSC_NO_BLITTERS
-/* modified blitters to work on a line basis with genesis plus renderer*/
-void md_ntsc_blit( md_ntsc_t const* ntsc, MD_NTSC_IN_T const* table, unsigned char* input,
-                   int in_width, int vline)
+
+/* modified blitters to filter the RGB565 lines of the genesis plus renderer */
+void md_ntsc_blit( md_ntsc_t const* ntsc, MD_NTSC_IN_T const* input, long in_row_width,
+                   int in_width, int in_height, void* rgb_out, long out_pitch )
 {
   int const chunk_count = in_width / md_ntsc_in_chunk - 1;
-  MD_NTSC_IN_T border = table[0];
-
-  MD_NTSC_BEGIN_ROW( ntsc, border,
-        MD_NTSC_ADJ_IN( table[*input++] ),
-        MD_NTSC_ADJ_IN( table[*input++] ),
-        MD_NTSC_ADJ_IN( table[*input++] ) );
-
-#ifdef NGC
-  /* directly fill the RGB565 texture */
-  /* one tile is 32 byte = 4x4 pixels */
-  /* tiles are stored continuously in texture memory */
-  in_width = MD_NTSC_OUT_WIDTH(in_width) >> 2;
-  int offset = ((in_width << 5) * (vline >> 2)) + ((vline & 3) * 8);
-  md_ntsc_out_t* restrict line_out  = (md_ntsc_out_t*)(texturemem + offset);
-#else
-  md_ntsc_out_t* restrict line_out  = (md_ntsc_out_t*)(&bitmap.data[(vline * bitmap.pitch)]);
-#endif
-
-  int n;
-
-  for ( n = chunk_count; n; --n )
+  for ( ; in_height; --in_height )
   {
-    /* order of input and output pixels must not be altered */
-    MD_NTSC_COLOR_IN( 0, ntsc, MD_NTSC_ADJ_IN( table[*input++] ) );
-    MD_NTSC_RGB_OUT( 0, *line_out++, MD_NTSC_OUT_DEPTH );
-    MD_NTSC_RGB_OUT( 1, *line_out++, MD_NTSC_OUT_DEPTH );
+    MD_NTSC_IN_T const* line_in = input;
+    MD_NTSC_BEGIN_ROW( ntsc, md_ntsc_black,
+          MD_NTSC_ADJ_IN( line_in [0] ),
+          MD_NTSC_ADJ_IN( line_in [1] ),
+          MD_NTSC_ADJ_IN( line_in [2] ) );
+    md_ntsc_out_t* restrict line_out = (md_ntsc_out_t*) rgb_out;
+    int n;
+    line_in += 3;
+
+    for ( n = chunk_count; n; --n )
+    {
+      /* order of input and output pixels must not be altered */
+      MD_NTSC_COLOR_IN( 0, ntsc, MD_NTSC_ADJ_IN( line_in [0] ) );
+      MD_NTSC_RGB_OUT( 0, line_out [0], MD_NTSC_OUT_DEPTH );
+      MD_NTSC_RGB_OUT( 1, line_out [1], MD_NTSC_OUT_DEPTH );
 
-    MD_NTSC_COLOR_IN( 1, ntsc, MD_NTSC_ADJ_IN( table[*input++] ) );
-    MD_NTSC_RGB_OUT( 2, *line_out++, MD_NTSC_OUT_DEPTH );
-    MD_NTSC_RGB_OUT( 3, *line_out++, MD_NTSC_OUT_DEPTH );
+      MD_NTSC_COLOR_IN( 1, ntsc, MD_NTSC_ADJ_IN( line_in [1] ) );
+      MD_NTSC_RGB_OUT( 2, line_out [2], MD_NTSC_OUT_DEPTH );
+      MD_NTSC_RGB_OUT( 3, line_out [3], MD_NTSC_OUT_DEPTH );
 
-#ifdef NGC
-    line_out += 12;
-#endif
+      MD_NTSC_COLOR_IN( 2, ntsc, MD_NTSC_ADJ_IN( line_in [2] ) );
+      MD_NTSC_RGB_OUT( 4, line_out [4], MD_NTSC_OUT_DEPTH );
+      MD_NTSC_RGB_OUT( 5, line_out [5], MD_NTSC_OUT_DEPTH );
 
-    MD_NTSC_COLOR_IN( 2, ntsc, MD_NTSC_ADJ_IN( table[*input++] ) );
-    MD_NTSC_RGB_OUT( 4, *line_out++, MD_NTSC_OUT_DEPTH );
-    MD_NTSC_RGB_OUT( 5, *line_out++, MD_NTSC_OUT_DEPTH );
+      MD_NTSC_COLOR_IN( 3, ntsc, MD_NTSC_ADJ_IN( line_in [3] ) );
+      MD_NTSC_RGB_OUT( 6, line_out [6], MD_NTSC_OUT_DEPTH );
+      MD_NTSC_RGB_OUT( 7, line_out [7], MD_NTSC_OUT_DEPTH );
 
-    MD_NTSC_COLOR_IN( 3, ntsc, MD_NTSC_ADJ_IN( table[*input++] ) );
-    MD_NTSC_RGB_OUT( 6, *line_out++, MD_NTSC_OUT_DEPTH );
-    MD_NTSC_RGB_OUT( 7, *line_out++, MD_NTSC_OUT_DEPTH );
+      line_in  += 4;
+      line_out += 8;
+    }
 
-  #ifdef NGC
-    line_out += 12;
-  #endif
-}
+    /* finish final pixels */
+    MD_NTSC_COLOR_IN( 0, ntsc, MD_NTSC_ADJ_IN( line_in [0] ) );
+    MD_NTSC_RGB_OUT( 0, line_out [0], MD_NTSC_OUT_DEPTH );
+    MD_NTSC_RGB_OUT( 1, line_out [1], MD_NTSC_OUT_DEPTH );
 
-  /* finish final pixels */
-  MD_NTSC_COLOR_IN( 0, ntsc, MD_NTSC_ADJ_IN( table[*input++] ) );
-  MD_NTSC_RGB_OUT( 0, *line_out++, MD_NTSC_OUT_DEPTH );
-  MD_NTSC_RGB_OUT( 1, *line_out++, MD_NTSC_OUT_DEPTH );
+    MD_NTSC_COLOR_IN( 1, ntsc, md_ntsc_black );
+    MD_NTSC_RGB_OUT( 2, line_out [2], MD_NTSC_OUT_DEPTH );
+    MD_NTSC_RGB_OUT( 3, line_out [3], MD_NTSC_OUT_DEPTH );
 
-  MD_NTSC_COLOR_IN( 1, ntsc, border );
-  MD_NTSC_RGB_OUT( 2, *line_out++, MD_NTSC_OUT_DEPTH );
-  MD_NTSC_RGB_OUT( 3, *line_out++, MD_NTSC_OUT_DEPTH );
+    MD_NTSC_COLOR_IN( 2, ntsc, md_ntsc_black );
+    MD_NTSC_RGB_OUT( 4, line_out [4], MD_NTSC_OUT_DEPTH );
+    MD_NTSC_RGB_OUT( 5, line_out [5], MD_NTSC_OUT_DEPTH );
 
-#ifdef NGC
-  line_out += 12;
-#endif
+    MD_NTSC_COLOR_IN( 3, ntsc, md_ntsc_black );
+    MD_NTSC_RGB_OUT( 6, line_out [6], MD_NTSC_OUT_DEPTH );
+    MD_NTSC_RGB_OUT( 7, line_out [7], MD_NTSC_OUT_DEPTH );
 
-  MD_NTSC_COLOR_IN( 2, ntsc, border );
-  MD_NTSC_RGB_OUT( 4, *line_out++, MD_NTSC_OUT_DEPTH );
-  MD_NTSC_RGB_OUT( 5, *line_out++, MD_NTSC_OUT_DEPTH );
-
-  MD_NTSC_COLOR_IN( 3, ntsc, border );
-  MD_NTSC_RGB_OUT( 6, *line_out++, MD_NTSC_OUT_DEPTH );
-  MD_NTSC_RGB_OUT( 7, *line_out++, MD_NTSC_OUT_DEPTH );
+    input += in_row_width;
+    rgb_out = (char*) rgb_out + out_pitch;
+  }
 }
 #endif
@@ -49,8 +49,8 @@ void md_ntsc_init( md_ntsc_t* ntsc, md_ntsc_setup_t const* setup );
 and output RGB depth is set by MD_NTSC_OUT_DEPTH. Both default to 16-bit RGB.
 In_row_width is the number of pixels to get to the next input row. Out_pitch
 is the number of *bytes* to get to the next output row. */
-void md_ntsc_blit( md_ntsc_t const* ntsc, MD_NTSC_IN_T const* table, unsigned char* input,
-    int in_width, int vline);
+void md_ntsc_blit( md_ntsc_t const* ntsc, MD_NTSC_IN_T const* input, long in_row_width,
+    int in_width, int in_height, void* rgb_out, long out_pitch );
 
 /* Number of output pixels written by blitter for given input width. */
 #define MD_NTSC_OUT_WIDTH( in_width ) \
@@ -100,9 +100,6 @@ EmuSystem::Error state_load(const unsigned char *buffer)
 {
 	auto state = std::make_unique<unsigned char[]>(STATE_SIZE);
 
-  /* buffer size */
-  uint bufferptr = 0;
-
   /* uncompress savestate */
   uint32 inbytes32;
   memcpy(&inbytes32, buffer, 4);
@@ -118,6 +115,14 @@ EmuSystem::Error state_load(const unsigned char *buffer)
 		}
   }
 
+  return state_load_raw(state.get(), outbytes);
+}
+
+EmuSystem::Error state_load_raw(unsigned char *state, unsigned long outbytes)
+{
+  /* buffer size */
+  uint bufferptr = 0;
+
   /* signature check (GENPLUS-GX x.x.x) */
   char version[17];
   load_param(version,16);
@@ -295,10 +300,8 @@ EmuSystem::Error state_load(const unsigned char *buffer)
   return {};
 }
 
-int state_save(unsigned char *buffer)
+int state_save_raw(unsigned char *state)
 {
-	auto state = std::make_unique<unsigned char[]>(STATE_SIZE);
-
   /* buffer size */
   int bufferptr = 0;
 
@@ -393,8 +396,15 @@ int state_save(unsigned char *buffer)
 	}
 	#endif
 
+  return bufferptr;
+}
+
+int state_save(unsigned char *buffer)
+{
+	auto state = std::make_unique<unsigned char[]>(STATE_SIZE);
+
   /* compress state file */
-  unsigned long inbytes   = bufferptr;
+  unsigned long inbytes   = state_save_raw(state.get());
   unsigned long outbytes  = STATE_SIZE;
   logMsg("compressing %d bytes to buffer of %d size", (int)inbytes, (int)outbytes);
   int ret = compress2 ((Bytef *)(buffer + 4), &outbytes, (Bytef *)state.get(), inbytes, 9);
@@ -27,6 +27,10 @@
 #include "Fir_Resampler.h"
 #include "eq.h"
 #include "assert.h"
+#include "ntsc/md_ntsc.h"
+#include "ntsc/sms_ntsc.h"
+#include <emuframework/EmuOptions.hh>
+#include <emuframework/VideoFilterThreads.hh>
 
 #ifndef NO_SCD
 #include <scd/scd.h>
@@ -50,6 +54,10 @@ static int pause_b;
 static EQSTATE eq;
 static int32 llp,rrp;
 static constexpr auto pixFmt = IG::PIXEL_FMT_RGB565;
+uint config_ntsc = 0;
+static md_ntsc_t *md_ntsc{};
+static sms_ntsc_t *sms_ntsc{};
+static IG::MemPixmap ntscPix{};
 
 /****************************************************************
  * Audio subsystem
@@ -295,6 +303,80 @@ int audio_update(int16 *sb)
 	return audioUpdateFunc(sb);
 }
 
+/****************************************************************
+ * NTSC filters
+ ****************************************************************/
+
+void system_set_ntsc_filter(uint preset)
+{
+  static md_ntsc_setup_t const *const md_setup[] {&md_ntsc_composite, &md_ntsc_svideo, &md_ntsc_rgb, &md_ntsc_monochrome};
+  static sms_ntsc_setup_t const *const sms_setup[] {&sms_ntsc_composite, &sms_ntsc_svideo, &sms_ntsc_rgb, &sms_ntsc_monochrome};
+  if (!preset || preset > IG::size(md_setup))
+  {
+    free(md_ntsc);
+    free(sms_ntsc);
+    md_ntsc = nullptr;
+    sms_ntsc = nullptr;
+    ntscPix = {};
+    config_ntsc = 0;
+    return;
+  }
+  if (!md_ntsc)
+    md_ntsc = (md_ntsc_t*)malloc(sizeof(md_ntsc_t));
+  if (!sms_ntsc)
+    sms_ntsc = (sms_ntsc_t*)malloc(sizeof(sms_ntsc_t));
+  if (!md_ntsc || !sms_ntsc)
+  {
+    system_set_ntsc_filter(0);
+    return;
+  }
+  md_ntsc_init(md_ntsc, md_setup[preset - 1]);
+  sms_ntsc_init(sms_ntsc, sms_setup[preset - 1]);
+  config_ntsc = preset;
+}
+
+/* returns the pixmap lines are rendered into, with the NTSC filter active
+   this is a native width buffer filtered into the frame by ntsc_end_frame() */
+static IG::Pixmap ntsc_start_frame(EmuVideo *emuVideo, EmuVideoImage &img, bool smsMode)
+{
+  int w = bitmap.viewport.w, h = bitmap.viewport.h;
+  if (!config_ntsc)
+  {
+    emuVideo->setFormat({{w, h}, pixFmt});
+    img = emuVideo->startFrame();
+    return img.pixmap();
+  }
+  if ((int)ntscPix.w() != w || (int)ntscPix.h() != h)
+  {
+    ntscPix = {{{w, h}, pixFmt}};
+  }
+  emuVideo->setFormat({{smsMode ? SMS_NTSC_OUT_WIDTH(w) : MD_NTSC_OUT_WIDTH(w), h}, pixFmt});
+  img = emuVideo->startFrame();
+  return ntscPix;
+}
+
+static void ntsc_end_frame(EmuVideoImage &img, bool smsMode)
+{
+  if (config_ntsc)
+  {
+    IG::Pixmap dest = img.pixmap();
+    uint rows = std::min(ntscPix.h(), dest.h());
+    /* bands of rows are independent, split them across the filter threads */
+    videoFilterThreads.run(rows, optionVideoFilterThreads,
+      [&dest, smsMode](uint startRow, uint endRow)
+      {
+        auto src = (const uint16*)ntscPix.pixel({0, (int)startRow});
+        auto out = dest.pixel({0, (int)startRow});
+        int srcW = ntscPix.w();
+        if (smsMode)
+          sms_ntsc_blit(sms_ntsc, src, ntscPix.pitchPixels(), srcW, endRow - startRow, out, dest.pitchBytes());
+        else
+          md_ntsc_blit(md_ntsc, src, ntscPix.pitchPixels(), srcW, endRow - startRow, out, dest.pitchBytes());
+      });
+  }
+  img.endFrame();
+}
+
 /****************************************************************
  * Virtual Genesis initialization
  ****************************************************************/
@@ -490,11 +572,11 @@ static void system_frame_md(EmuVideo *emuVideo)
   mcycles_vdp += MCYCLES_PER_LINE;
 
   EmuVideoImage img{};
+  IG::Pixmap pix{};
   if(!do_skip)
   {
-  	emuVideo->setFormat({{bitmap.viewport.w, bitmap.viewport.h}, pixFmt});
-  	img = emuVideo->startFrame();
-  	gPixmap = img.pixmap();
+  	pix = ntsc_start_frame(emuVideo, img, false);
+  	gPixmap = pix;
   }
 
   /* Active Display */
@@ -533,7 +615,7 @@ static void system_frame_md(EmuVideo *emuVideo)
     /* render scanline */
     if (!do_skip)
     {
-      render_line(line, img.pixmap());
+      render_line(line, pix);
     }
 
     /* run 68k & Z80 */
@@ -567,7 +649,7 @@ static void system_frame_md(EmuVideo *emuVideo)
 
   if(img)
   {
-  	img.endFrame();
+  	ntsc_end_frame(img, false);
   	gPixmap = {};
   }
 
@@ -888,10 +970,10 @@ static void system_frame_sms(EmuVideo *emuVideo)
   vscroll = reg[0x09];
 
   EmuVideoImage img{};
+  IG::Pixmap pix{};
   if(!do_skip)
   {
-  	emuVideo->setFormat({{bitmap.viewport.w, bitmap.viewport.h}, pixFmt});
-  	img = emuVideo->startFrame();
+  	pix = ntsc_start_frame(emuVideo, img, true);
   }
 
   /* Active Display */
@@ -912,7 +994,7 @@ static void system_frame_sms(EmuVideo *emuVideo)
       /* render scanline */
       if (!do_skip)
       {
-        render_line(line, img.pixmap());
+        render_line(line, pix);
       }
     }
 
@@ -951,7 +1033,7 @@ static void system_frame_sms(EmuVideo *emuVideo)
   while (++line < bitmap.viewport.h);
 
   if(img)
-  	img.endFrame();
+  	ntsc_end_frame(img, true);
 
   /* end of active display */
   v_counter = line;
@@ -92,6 +92,7 @@ extern void system_init(void);
 extern void system_reset(void);
 extern void system_shutdown(void);
 extern void (*system_frame)(EmuVideo *emuVideo);
+extern void system_set_ntsc_filter(uint preset);
 
 static bool emuSystemIs16Bit()
 {
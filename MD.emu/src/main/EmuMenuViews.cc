@@ -4,6 +4,7 @@
 #include "internal.hh"
 #include "input.h"
 #include "io_ctrl.h"
+#include "system.h"
 
 class CustomVideoOptionView : public VideoOptionView
 {
@@ -21,12 +22,35 @@ class CustomVideoOptionView : public VideoOptionView
 		videoSystemItem
 	};
 
+	TextMenuItem ntscFilterItem[5]
+	{
+		{"Off", [](){ setNtscFilter(0); }},
+		{"Composite", [](){ setNtscFilter(1); }},
+		{"S-Video", [](){ setNtscFilter(2); }},
+		{"RGB", [](){ setNtscFilter(3); }},
+		{"Monochrome", [](){ setNtscFilter(4); }},
+	};
+
+	MultiChoiceMenuItem ntscFilter
+	{
+		"NTSC Filter",
+		std::min((int)optionNtscFilter, 4),
+		ntscFilterItem
+	};
+
+	static void setNtscFilter(uint preset)
+	{
+		optionNtscFilter = preset;
+		system_set_ntsc_filter(preset);
+	}
+
 public:
 	CustomVideoOptionView(ViewAttachParams attach): VideoOptionView{attach, true}
 	{
 		loadStockItems();
 		item.emplace_back(&systemSpecificHeading);
 		item.emplace_back(&videoSystem);
+		item.emplace_back(&ntscFilter);
 	}
 };
 
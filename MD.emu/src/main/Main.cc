@@ -38,6 +38,7 @@
 const char *EmuSystem::creditsViewStr = CREDITS_INFO_STRING "(c) 2011-2018\nRobert Broglia\nwww.explusalpha.com\n\nPortions (c) the\nGenesis Plus Team\ncgfm2.emuviews.com";
 bool EmuSystem::hasCheats = true;
 bool EmuSystem::hasPALVideoSystem = true;
+bool EmuSystem::hasVideoFilters = true;
 t_config config{};
 uint config_ym2413_enabled = 1;
 int8 mdInputPortDev[2]{-1, -1};
@@ -172,6 +173,54 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 	return loadMDState(path);
 }
 
+// the held buttons aren't part of the core's state, store them and the state size before it
+static const uint stateMemHeaderSize = sizeof(uint32) + sizeof(input.pad);
+
+size_t EmuSystem::stateMemSize()
+{
+	return stateMemHeaderSize + STATE_SIZE;
+}
+
+bool EmuSystem::saveStateMem(void *buff, size_t size)
+{
+	auto data = (uchar*)buff;
+	uint32 stateSize = state_save_raw(&data[stateMemHeaderSize]);
+	memcpy(data, &stateSize, sizeof(uint32));
+	memcpy(&data[sizeof(uint32)], input.pad, sizeof(input.pad));
+	return true;
+}
+
+bool EmuSystem::loadStateMem(const void *buff, size_t size)
+{
+	// the core's load functions take non-const pointers but only read from them
+	auto data = (uchar*)buff;
+	uint32 stateSize;
+	memcpy(&stateSize, data, sizeof(uint32));
+	if(auto err = state_load_raw(&data[stateMemHeaderSize], stateSize);
+		err)
+	{
+		logErr("error loading state: %s", err->what());
+		return false;
+	}
+	memcpy(input.pad, &data[sizeof(uint32)], sizeof(input.pad));
+	return true;
+}
+
+uint EmuSystem::memSearchRegions(MemSearchRegion (&region)[MAX_MEM_SEARCH_REGIONS])
+{
+	if(!gameIsRunning())
+		return 0;
+	// 68K RAM is stored as native 16-bit words
+	#ifdef LSB_FIRST
+	bool wordSwapped = true;
+	#else
+	bool wordSwapped = false;
+	#endif
+	region[0] = {work_ram, sizeof(work_ram), 0xFF0000, wordSwapped};
+	region[1] = {zram, sizeof(zram), 0xA00000, false};
+	return 2;
+}
+
 void EmuSystem::saveBackupMem() // for manually saving when not closing game
 {
 	if(!gameIsRunning())
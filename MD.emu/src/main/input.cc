@@ -123,6 +123,11 @@ void EmuSystem::handleInputAction(uint state, uint emuKey)
 	padData = IG::setOrClearBits(padData, (uint16)emuKey, state == Input::PUSHED);
 }
 
+uint EmuSystem::inputActionForPlayer(uint emuKey, uint player)
+{
+	return (emuKey & 0x3FFFFFFF) | (player << 30);
+}
+
 bool EmuSystem::handlePointerInputEvent(Input::Event e, IG::WindowRect gameRect)
 {
 	const int gunDevIdx = 4;
@@ -23,6 +23,7 @@ extern PathOption optionCDBiosJpnPath;
 extern PathOption optionCDBiosEurPath;
 #endif
 extern Byte1Option optionVideoSystem;
+extern Byte1Option optionNtscFilter;
 
 void setupMDInput();
 bool hasMDExtension(const char *name);
@@ -16,6 +16,7 @@
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuInput.hh>
 #include "internal.hh"
+#include "system.h"
 
 enum
 {
@@ -23,6 +24,7 @@ enum
 	CFGKEY_6_BTN_PAD = 280, CFGKEY_MD_CD_BIOS_USA_PATH = 281,
 	CFGKEY_MD_CD_BIOS_JPN_PATH = 282, CFGKEY_MD_CD_BIOS_EUR_PATH = 283,
 	CFGKEY_MD_REGION = 284, CFGKEY_VIDEO_SYSTEM = 285,
+	CFGKEY_NTSC_FILTER = 286,
 };
 
 const char *EmuSystem::configFilename = "MdEmu.config";
@@ -43,6 +45,7 @@ PathOption optionCDBiosJpnPath{CFGKEY_MD_CD_BIOS_JPN_PATH, cdBiosJpnPath, ""};
 PathOption optionCDBiosEurPath{CFGKEY_MD_CD_BIOS_EUR_PATH, cdBiosEurPath, ""};
 #endif
 Byte1Option optionVideoSystem{CFGKEY_VIDEO_SYSTEM, 0};
+Byte1Option optionNtscFilter{CFGKEY_NTSC_FILTER, 0, 0, optionIsValidWithMax<4>};
 
 void EmuSystem::initOptions()
 {
@@ -54,6 +57,7 @@ EmuSystem::Error EmuSystem::onOptionsLoaded()
 {
 	EmuControls::setActiveFaceButtons(option6BtnPad ? 6 : 3);
 	config_ym2413_enabled = optionSmsFM;
+	system_set_ntsc_filter(optionNtscFilter);
 	return {};
 }
 
@@ -80,6 +84,7 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 				optionRegion = 0;
 		}
 		bcase CFGKEY_VIDEO_SYSTEM: optionVideoSystem.readFromIO(io, readSize);
+		bcase CFGKEY_NTSC_FILTER: optionNtscFilter.readFromIO(io, readSize);
 		bdefault: return 0;
 	}
 	return 1;
@@ -91,6 +96,7 @@ void EmuSystem::writeConfig(IO &io)
 	optionSmsFM.writeWithKeyIfNotDefault(io);
 	option6BtnPad.writeWithKeyIfNotDefault(io);
 	optionVideoSystem.writeWithKeyIfNotDefault(io);
+	optionNtscFilter.writeWithKeyIfNotDefault(io);
 	#ifndef NO_SCD
 	optionCDBiosUsaPath.writeToIO(io);
 	optionCDBiosJpnPath.writeToIO(io);
@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
 #include <assert.h>
 
 #define BITSPERSAMPLE     16
@@ -118,6 +119,7 @@ struct Mixer
     UInt32 index;
     UInt32 volIndex;
     Int16   buffer[AUDIO_STEREO_BUFFER_SIZE];
+    Int32   mixBuffer[AUDIO_STEREO_BUFFER_SIZE];
     AudioTypeInfo audioTypeInfo[MIXER_CHANNEL_TYPE_COUNT];
     MixerChannel channels[MAX_CHANNELS];
     MixerChannel midi; // This channel is only used for meter output
@@ -338,6 +340,183 @@ static void updateVolumes(Mixer* mixer)
     }
 }
 
+///////////////////////////////////////////////////////
+// Block mixer
+//
+// Each channel is mixed over the whole sync interval into mixBuffer
+// (interleaved L/R when the mixer is stereo), then the sum is scaled,
+// clipped and copied to the output buffer. Lanes are four Int32 wide and
+// give the same results as mixing one sample at a time.
+
+typedef Int32 MixVec __attribute__((vector_size(16)));
+typedef Int16 MixVec16 __attribute__((vector_size(8)));
+
+static inline MixVec mixLoad(const Int32* p)
+{
+    MixVec v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void mixStore(Int32* p, MixVec v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline MixVec mixAbs(MixVec v)
+{
+    MixVec sign = v >> 31;
+    return (v ^ sign) - sign;
+}
+
+static int mixIsSilent(const Int32* src, UInt32 length)
+{
+    MixVec any = { 0 };
+    Int32 tail = 0;
+    UInt32 j = 0;
+
+    for (; j + 4 <= length; j += 4) {
+        any |= mixLoad(src + j);
+    }
+    for (; j < length; j++) {
+        tail |= src[j];
+    }
+    return (any[0] | any[1] | any[2] | any[3] | tail) == 0;
+}
+
+static void mixChannelStereo(MixerChannel* channel, const Int32* src, Int32* mix, UInt32 count)
+{
+    Int32 volLeft  = channel->volumeLeft;
+    Int32 volRight = channel->volumeRight;
+    MixVec vol = { volLeft, volRight, volLeft, volRight };
+    MixVec cnt = { 0 };
+    Int32 cntLeft = 0;
+    Int32 cntRight = 0;
+    UInt32 j = 0;
+
+    if (channel->stereo) {
+        UInt32 length = 2 * count;
+        for (; j + 4 <= length; j += 4) {
+            MixVec s = vol * mixLoad(src + j);
+            cnt += mixAbs(s) / 2048;
+            mixStore(mix + j, mixLoad(mix + j) + s);
+        }
+        for (; j < length; j += 2) {
+            Int32 chanLeft  = volLeft  * src[j];
+            Int32 chanRight = volRight * src[j + 1];
+            cntLeft  += (chanLeft  > 0 ? chanLeft  : -chanLeft)  / 2048;
+            cntRight += (chanRight > 0 ? chanRight : -chanRight) / 2048;
+            mix[j]     += chanLeft;
+            mix[j + 1] += chanRight;
+        }
+    }
+    else {
+        for (; j + 2 <= count; j += 2) {
+            MixVec s = { src[j], src[j], src[j + 1], src[j + 1] };
+            s *= vol;
+            cnt += mixAbs(s) / 2048;
+            mixStore(mix + 2 * j, mixLoad(mix + 2 * j) + s);
+        }
+        for (; j < count; j++) {
+            Int32 chanLeft  = volLeft  * src[j];
+            Int32 chanRight = volRight * src[j];
+            cntLeft  += (chanLeft  > 0 ? chanLeft  : -chanLeft)  / 2048;
+            cntRight += (chanRight > 0 ? chanRight : -chanRight) / 2048;
+            mix[2 * j]     += chanLeft;
+            mix[2 * j + 1] += chanRight;
+        }
+    }
+
+    channel->volCntLeft  += cnt[0] + cnt[2] + cntLeft;
+    channel->volCntRight += cnt[1] + cnt[3] + cntRight;
+}
+
+static void mixChannelMono(MixerChannel* channel, const Int32* src, Int32* mix, UInt32 count)
+{
+    Int32 volLeft = channel->volumeLeft;
+    MixVec cnt = { 0 };
+    Int32 cntTail = 0;
+    UInt32 j = 0;
+
+    if (channel->stereo) {
+        for (; j + 4 <= count; j += 4) {
+            const Int32* p = src + 2 * j;
+            MixVec s = { p[0] + p[1], p[2] + p[3], p[4] + p[5], p[6] + p[7] };
+            s = volLeft * s / 2;
+            cnt += mixAbs(s) / 2048;
+            mixStore(mix + j, mixLoad(mix + j) + s);
+        }
+        for (; j < count; j++) {
+            Int32 chanLeft = volLeft * (src[2 * j] + src[2 * j + 1]) / 2;
+            cntTail += (chanLeft > 0 ? chanLeft : -chanLeft) / 2048;
+            mix[j] += chanLeft;
+        }
+    }
+    else {
+        for (; j + 4 <= count; j += 4) {
+            MixVec s = volLeft * mixLoad(src + j);
+            cnt += mixAbs(s) / 2048;
+            mixStore(mix + j, mixLoad(mix + j) + s);
+        }
+        for (; j < count; j++) {
+            Int32 chanLeft = volLeft * src[j];
+            cntTail += (chanLeft > 0 ? chanLeft : -chanLeft) / 2048;
+            mix[j] += chanLeft;
+        }
+    }
+
+    cntTail += cnt[0] + cnt[1] + cnt[2] + cnt[3];
+    channel->volCntLeft  += cntTail;
+    channel->volCntRight += cntTail;
+}
+
+// Scales and clips length mixed samples into dest, which must start on a
+// left sample when the mixer is stereo
+static void mixClip(Mixer* mixer, const Int32* mix, Int16* dest, UInt32 length)
+{
+    const MixVec maxVal = { 32767, 32767, 32767, 32767 };
+    const MixVec minVal = -maxVal;
+    MixVec cnt = { 0 };
+    Int32 cntLeft = 0;
+    Int32 cntRight = 0;
+    UInt32 j = 0;
+
+    for (; j + 4 <= length; j += 4) {
+        MixVec v = mixLoad(mix + j) / 4096;
+        MixVec over, under;
+        MixVec16 out;
+        cnt += mixAbs(v);
+        over  = v > maxVal;
+        under = v < minVal;
+        v = (v & ~(over | under)) | (maxVal & over) | (minVal & under);
+        out = __builtin_convertvector(v, MixVec16);
+        memcpy(dest + j, &out, sizeof(out));
+    }
+    for (; j < length; j++) {
+        Int32 v = mix[j] / 4096;
+        Int32 a = v > 0 ? v : -v;
+        if (mixer->stereo && (j & 1)) {
+            cntRight += a;
+        }
+        else {
+            cntLeft += a;
+        }
+        if (v >  32767) v =  32767;
+        if (v < -32767) v = -32767;
+        dest[j] = (Int16)v;
+    }
+
+    if (mixer->stereo) {
+        mixer->volCntLeft  += cnt[0] + cnt[2] + cntLeft;
+        mixer->volCntRight += cnt[1] + cnt[3] + cntRight;
+    }
+    else {
+        cntLeft += cnt[0] + cnt[1] + cnt[2] + cnt[3];
+        mixer->volCntLeft  += cntLeft;
+        mixer->volCntRight += cntLeft;
+    }
+}
+
 static Mixer* globalMixer = NULL;
 
 Mixer* mixerGetGlobalMixer()
@@ -506,111 +685,51 @@ void mixerSync(Mixer* mixer)
         }
     }
 
-    if (mixer->stereo) {
-        while (count--) {
-            Int32 left = 0;
-            Int32 right = 0;
-
-            for (i = 0; i < mixer->channelCount; i++) {
-                Int32 chanLeft;
-                Int32 chanRight;
+    memset(mixer->mixBuffer, 0, count * (mixer->stereo ? 2 : 1) * sizeof(Int32));
 
-                if (chBuff[i] == NULL) {
-                    continue;
-                }
-
-                if (mixer->channels[i].stereo) {
-                    chanLeft = mixer->channels[i].volumeLeft * *chBuff[i]++;
-                    chanRight = mixer->channels[i].volumeRight * *chBuff[i]++;
-                }
-                else {
-                    Int32 tmp = *chBuff[i]++;
-                    chanLeft = mixer->channels[i].volumeLeft * tmp;
-                    chanRight = mixer->channels[i].volumeRight * tmp;
-                }
+    for (i = 0; i < mixer->channelCount; i++) {
+        MixerChannel* channel = mixer->channels + i;
+        UInt32 length = count * (channel->stereo ? 2 : 1);
 
-                mixer->channels[i].volCntLeft  += (chanLeft  > 0 ? chanLeft  : -chanLeft)  / 2048;
-                mixer->channels[i].volCntRight += (chanRight > 0 ? chanRight : -chanRight) / 2048;
+        if (chBuff[i] == NULL) {
+            continue;
+        }
 
-                left  += chanLeft;
-                right += chanRight;
+        if ((channel->volumeLeft | channel->volumeRight) != 0 && !mixIsSilent(chBuff[i], length)) {
+            if (mixer->stereo) {
+                mixChannelStereo(channel, chBuff[i], mixer->mixBuffer, count);
             }
-
-            left  /= 4096;
-            right /= 4096;
-
-            mixer->volCntLeft  += left  > 0 ? left  : -left;
-            mixer->volCntRight += right > 0 ? right : -right;
-
-            if (left  >  32767) { left  = 32767; }
-            if (left  < -32767) { left  = -32767; }
-            if (right >  32767) { right = 32767; }
-            if (right < -32767) { right = -32767; }
-
-            buffer[mixer->index++] = (Int16)left;
-            buffer[mixer->index++] = (Int16)right;
-
-            if (mixer->index == mixer->fragmentSize) {
-                if (mixer->writeCallback != NULL) {
-                    mixer->writeCallback(mixer->writeRef, buffer, mixer->fragmentSize);
-                }
-                /*if (mixer->logging) {
-                    fwrite(buffer, 2 * mixer->fragmentSize, 1, mixer->file);
-                }*/
-                mixer->index = 0;
+            else {
+                mixChannelMono(channel, chBuff[i], mixer->mixBuffer, count);
             }
-
-            mixer->volIndex++;
         }
-    }
-    else {
-        while (count--) {
-            Int32 left = 0;
-
-            for (i = 0; i < mixer->channelCount; i++) {
-                Int32 chanLeft;
 
-                if (chBuff[i] == NULL) {
-                    continue;
-                }
-
-                if (mixer->channels[i].stereo) {
-                    Int32 tmp = *chBuff[i]++;
-                    chanLeft = mixer->channels[i].volumeLeft * (tmp + *chBuff[i]++) / 2;
-                }
-                else {
-                    chanLeft = mixer->channels[i].volumeLeft * *chBuff[i]++;
-                }
-            
-                mixer->channels[i].volCntLeft  += (chanLeft > 0 ? chanLeft : -chanLeft) / 2048;
-                mixer->channels[i].volCntRight += (chanLeft > 0 ? chanLeft : -chanLeft) / 2048;
-                left  += chanLeft;
-            }
+        chBuff[i] += length;
+    }
 
-            left  /= 4096;
+    {
+        UInt32 length = count * (mixer->stereo ? 2 : 1);
+        Int32* mix = mixer->mixBuffer;
 
-            mixer->volCntLeft  += left > 0 ? left : -left;
-            mixer->volCntRight += left > 0 ? left : -left;
+        while (length > 0) {
+            UInt32 chunk = MIN(length, (UInt32)mixer->fragmentSize - mixer->index);
 
-            if (left  >  32767) left  = 32767;
-            if (left  < -32767) left  = -32767;
+            mixClip(mixer, mix, buffer + mixer->index, chunk);
+            mixer->index += chunk;
+            mix          += chunk;
+            length       -= chunk;
 
-            buffer[mixer->index++] = (Int16)left;
-            
             if (mixer->index == mixer->fragmentSize) {
                 if (mixer->writeCallback != NULL) {
                     mixer->writeCallback(mixer->writeRef, buffer, mixer->fragmentSize);
                 }
-                /*if (mixer->logging) {
-                    fwrite(buffer, 2 * mixer->fragmentSize, 1, mixer->file);
-                }*/
                 mixer->index = 0;
             }
-
-            mixer->volIndex++;
         }
     }
 
+    mixer->volIndex += count;
+
     if (mixer->volIndex >= 441) {
         Int32 newVolumeLeft  = mixer->volCntLeft  / mixer->volIndex / 164;
         Int32 newVolumeRight = mixer->volCntRight / mixer->volIndex / 164;
@@ -42,12 +42,11 @@ void boardChangeDiskette(int driveId, char* fileName, const char* fileInZipFile)
     diskChange(driveId, fileName, fileInZipFile);
 }
 
-bool fdcActive = 0;
 extern Byte1Option optionSkipFdcAccess;
 
 static void onFdcDone(void* ref, UInt32 time)
 {
-    fdcActive = 0;
+    EmuSystem::setMediaBusy(false);
     logMsg("ended FDC activity");
 }
 
@@ -55,10 +54,10 @@ void boardSetFdcActive()
 {
 	if(optionSkipFdcAccess)
 	{
-		if(!fdcActive)
+		if(!EmuSystem::mediaBusy)
 			logMsg("FDC active");
 		boardTimerAdd(fdcTimer, boardSystemTime() + (UInt32)((UInt64)300 * boardFrequency() / 1000));
-		fdcActive = 1;
+		EmuSystem::setMediaBusy(true);
 	}
 }
 
@@ -248,7 +248,7 @@ static void destroyMSX()
 {
 	assert(machine);
 	logMsg("destroying MSX");
-	fdcActive = 0;
+	EmuSystem::setMediaBusy(false);
 	if(msxIsInit())
 	{
 		ejectMedia();
@@ -432,7 +432,7 @@ bool insertDisk(const char *name, uint slot)
 void EmuSystem::reset(ResetMode mode)
 {
 	assert(gameIsRunning());
-	fdcActive = 0;
+	EmuSystem::setMediaBusy(false);
 	//boardInfo.softReset();
 	boardInfo.destroy();
 	if(!createBoard())
@@ -496,7 +496,11 @@ static EmuSystem::Error saveBlueMSXState(const char *filename)
 	machineSaveState(machine);
 	boardInfo.saveState();
 	saveStateDestroy();
-	zipEndWrite();
+	if(zipEndWrite() != OK)
+	{
+		logErr("error writing state:%s", filename);
+		return EmuSystem::makeFileWriteError();
+	}
 	return {};
 }
 
@@ -744,32 +748,6 @@ void RefreshScreen(int screenMode)
 
 void EmuSystem::runFrame(EmuVideo *video, bool renderAudio)
 {
-	// fast-forward during floppy access, but stop if access ends
-	if(unlikely(fdcActive && video))
-	{
-		iterateTimes(4, i)
-		{
-			boardInfo.run(boardInfo.cpuRef);
-			((R800*)boardInfo.cpuRef)->terminate = 0;
-			bool useFrame = !fdcActive;
-			if(useFrame)
-			{
-				logMsg("FDC activity ended while fast-forwarding");
-				emuVideo = video;
-				commitVideoFrame();
-			}
-			mixerSync(mixer);
-			UInt32 samples;
-			uchar *audio = (uchar*)mixerGetBuffer(mixer, &samples);
-			if(useFrame)
-			{
-				writeSound(audio, samples/2);
-				return; // done with frame for this update
-			}
-		}
-	}
-
-	// regular frame update
 	emuVideo = video;
 	boardInfo.run(boardInfo.cpuRef);
 	((R800*)boardInfo.cpuRef)->terminate = 0;
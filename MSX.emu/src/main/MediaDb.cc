@@ -38,6 +38,7 @@ extern "C" {
 }
 
 #include <string.h>
+#include <algorithm>
 #include <imagine/util/builtins.h>
 #include <imagine/util/algorithm.h>
 #include <imagine/logger/logger.h>
@@ -53,11 +54,34 @@ struct RomDBInfo
 	uint romType;
 };
 
-static const RomDBInfo romDB[] =
+// sorted by digest for binary search, keep the order when adding entries
+static constexpr RomDBInfo romDB[] =
 {
 #include "EmbeddedRomDBData.h"
 };
 
+static constexpr bool digestLess(const uint *a, const uint *b)
+{
+	for(uint i = 0; i < 5; i++)
+	{
+		if(a[i] != b[i])
+			return a[i] < b[i];
+	}
+	return false;
+}
+
+static constexpr bool romDBIsSorted()
+{
+	for(uint i = 1; i < std::size(romDB); i++)
+	{
+		if(!digestLess(romDB[i - 1].digest, romDB[i].digest))
+			return false;
+	}
+	return true;
+}
+
+static_assert(romDBIsSorted(), "EmbeddedRomDBData.h must be sorted by digest without duplicates");
+
 struct MediaType {
     constexpr MediaType(RomType rt) : romType(rt) {}
 
@@ -556,21 +580,13 @@ extern "C" MediaType* mediaDbLookupRom(const void *buffer, int size)
 		sha1.get_digest(digest);
 		logMsg("rom sha1 0x%X 0x%X 0x%X 0x%X 0x%X", digest[0], digest[1], digest[2], digest[3], digest[4]);
 
-		for(auto e : romDB)
+		auto e = std::lower_bound(std::begin(romDB), std::end(romDB), digest,
+			[](const RomDBInfo &e, const unsigned int *digest){ return digestLess(e.digest, digest); });
+		if(e != std::end(romDB) && !digestLess(digest, e->digest))
 		{
-			int match = 0;
-			iterateTimes(5, i)
-			{
-					if(digest[i] != e.digest[i])
-						break;
-					else match++;
-			}
-			if(match == 5)
-			{
-				logMsg("found match with type %s", romTypeToString(e.romType));
-				staticMediaType = e.romType;
-				return &staticMediaType;
-			}
+			logMsg("found match with type %s", romTypeToString(e->romType));
+			staticMediaType = e->romType;
+			return &staticMediaType;
 		}
 
 		logMsg("rom not in DB");
@@ -19,7 +19,6 @@ extern FS::FileString cartName[2];
 extern FS::FileString diskName[2];
 extern uint activeBoardType;
 extern BoardInfo boardInfo;
-extern bool fdcActive;
 
 static const char *installFirmwareFilesMessage =
 	#if defined CONFIG_BASE_ANDROID
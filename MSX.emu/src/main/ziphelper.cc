@@ -14,24 +14,176 @@
 	along with MSX.emu.  If not, see <http://www.gnu.org/licenses/> */
 
 #define LOGTAG "main"
-#include <archive.h>
-#include <archive_entry.h>
 #include <imagine/fs/ArchiveFS.hh>
+#include <imagine/io/FileIO.hh>
 #include <imagine/logger/logger.h>
 #include <imagine/util/string.h>
 #include <imagine/util/ScopeGuard.hh>
 #include "ziphelper.h"
+#include "internal.hh"
+#include <zlib.h>
 #include <cstdlib>
+#include <vector>
 
-static struct archive *writeArch{};
+// States are written as one memory blob instead of a zip entry per device:
+// StateFileHeader, then the blob, deflated once as a whole unless
+// MSX_STATE_NO_COMPRESSION is defined. The blob starts with a section count
+// and an index of StateSection entries, followed by the section data.
+// Older zip states are still read, through the same in-memory cache.
+
+struct StateFileHeader
+{
+	char magic[8];
+	uint32 version;
+	uint32 flags;
+	uint32 dataSize; // uncompressed blob size
+	uint32 storedSize;
+};
+
+struct StateSection
+{
+	char name[64];
+	uint32 offset;
+	uint32 size;
+};
+
+static constexpr char stateMagic[8]{'M', 'S', 'X', 'S', 'T', 'A', 'T', 'E'};
+static constexpr uint32 STATE_FORMAT_VERSION = 1;
+static constexpr uint32 STATE_FLAG_DEFLATE = IG::bit(0);
+
+static FileIO writeFile{};
+static std::vector<StateSection> writeIndex{};
+static std::vector<char> writeData{};
+
+// sections of the state opened by zipCacheReadOnlyZip()
+static FS::PathString cachedZipName{};
+static std::vector<StateSection> cachedIndex{};
+static std::vector<char> cachedData{};
+
+static void clearZipCache()
+{
+	cachedZipName = {};
+	cachedIndex = {};
+	cachedData = {};
+}
+
+static bool readStateBlob(FileIO &file, std::vector<char> &data)
+{
+	StateFileHeader header;
+	if(file.readAtPos(&header, sizeof(header), 0) != (ssize_t)sizeof(header)
+		|| memcmp(header.magic, stateMagic, sizeof(stateMagic)) != 0)
+	{
+		return false;
+	}
+	if(header.version != STATE_FORMAT_VERSION)
+	{
+		logErr("unsupported state format version:%u", header.version);
+		return false;
+	}
+	std::vector<char> stored(header.storedSize);
+	if(file.readAtPos(stored.data(), stored.size(), sizeof(header)) != (ssize_t)stored.size())
+		return false;
+	if(header.flags & STATE_FLAG_DEFLATE)
+	{
+		data.resize(header.dataSize);
+		uLongf dataSize = header.dataSize;
+		if(uncompress((Bytef*)data.data(), &dataSize, (const Bytef*)stored.data(), stored.size()) != Z_OK
+			|| dataSize != header.dataSize)
+		{
+			logErr("error inflating state data");
+			return false;
+		}
+	}
+	else
+	{
+		data = std::move(stored);
+	}
+	return true;
+}
+
+static bool cacheStateFile(const char *zipName)
+{
+	FileIO file;
+	file.open(zipName, IO::AccessHint::ALL);
+	if(!file)
+		return false;
+	std::vector<char> data;
+	if(!readStateBlob(file, data))
+		return false;
+	uint32 sections;
+	if(data.size() < sizeof(sections))
+		return false;
+	memcpy(&sections, data.data(), sizeof(sections));
+	size_t indexEnd = sizeof(sections) + sections * sizeof(StateSection);
+	if(indexEnd > data.size())
+		return false;
+	cachedIndex.resize(sections);
+	memcpy(cachedIndex.data(), data.data() + sizeof(sections), sections * sizeof(StateSection));
+	for(auto &s : cachedIndex)
+	{
+		if((size_t)s.offset + s.size > data.size())
+			return false;
+		s.name[sizeof(s.name) - 1] = 0;
+	}
+	cachedData = std::move(data);
+	return true;
+}
+
+static bool cacheZipFile(const char *zipName)
+{
+	std::error_code ec{};
+	for(auto &entry : FS::ArchiveIterator{zipName, ec})
+	{
+		if(entry.type() == FS::file_type::directory)
+		{
+			continue;
+		}
+		StateSection s{};
+		string_copy(s.name, entry.name());
+		auto io = entry.moveIO();
+		s.size = io.size();
+		s.offset = cachedData.size();
+		cachedData.resize(cachedData.size() + s.size);
+		if(io.read(&cachedData[s.offset], s.size) != (ssize_t)s.size)
+			return false;
+		cachedIndex.push_back(s);
+	}
+	return !ec;
+}
 
 void zipCacheReadOnlyZip(const char* zipName)
 {
-	// TODO
+	clearZipCache();
+	if(!zipName)
+		return;
+	if(cacheStateFile(zipName) || cacheZipFile(zipName))
+	{
+		string_copy(cachedZipName, zipName);
+		logMsg("cached %zu state sections from:%s", cachedIndex.size(), zipName);
+	}
+	else
+	{
+		clearZipCache();
+	}
 }
 
 void* zipLoadFile(const char* zipName, const char* fileName, int* size)
 {
+	if(strlen(cachedZipName.data()) && string_equal(zipName, cachedZipName.data()))
+	{
+		for(const auto &s : cachedIndex)
+		{
+			if(string_equal(s.name, fileName))
+			{
+				void *buff = malloc(s.size);
+				memcpy(buff, &cachedData[s.offset], s.size);
+				*size = s.size;
+				return buff;
+			}
+		}
+		logErr("file %s not in state:%s", fileName, zipName);
+		return nullptr;
+	}
 	ArchiveIO io{};
 	std::error_code ec{};
 	for(auto &entry : FS::ArchiveIterator{zipName, ec})
@@ -66,44 +218,73 @@ void* zipLoadFile(const char* zipName, const char* fileName, int* size)
 
 CallResult zipStartWrite(const char *fileName)
 {
-	assert(!writeArch);
-	writeArch = archive_write_new();
-	archive_write_set_format_zip(writeArch);
-	if(archive_write_open_filename(writeArch, fileName) != ARCHIVE_OK)
+	assert(!writeFile);
+	writeFile.create(fileName);
+	if(!writeFile)
 	{
-		archive_write_free(writeArch);
-		writeArch = {};
 		return IO_ERROR;
 	}
+	writeIndex.clear();
+	writeData.clear();
 	return OK;
 }
 
 int zipSaveFile(const char* zipName, const char* fileName, int append, const void* buffer, int size)
 {
-	assert(writeArch);
-	auto entry = archive_entry_new();
-	auto freeEntry = IG::scopeGuard([&](){ archive_entry_free(entry); });
-	archive_entry_set_pathname(entry, fileName);
-	archive_entry_set_size(entry, size);
-	archive_entry_set_filetype(entry, AE_IFREG);
-	archive_entry_set_perm(entry, 0644);
-	if(archive_write_header(writeArch, entry) < ARCHIVE_OK)
-	{
-		logErr("error writing archive header: %s", archive_error_string(writeArch));
-		return 0;
-	}
-	if(archive_write_data(writeArch, buffer, size) < ARCHIVE_OK)
+	assert(writeFile);
+	StateSection s{};
+	if(string_copy(s.name, fileName) >= sizeof(s.name))
 	{
-		logErr("error writing archive data: %s", archive_error_string(writeArch));
+		logErr("state section name too long:%s", fileName);
 		return 0;
 	}
+	s.offset = writeData.size();
+	s.size = size;
+	writeData.insert(writeData.end(), (const char*)buffer, (const char*)buffer + size);
+	writeIndex.push_back(s);
 	return 1;
 }
 
-void zipEndWrite()
+CallResult zipEndWrite()
 {
-	assert(writeArch);
-	archive_write_close(writeArch);
-	archive_write_free(writeArch);
-	writeArch = {};
+	assert(writeFile);
+	auto closeFile = IG::scopeGuard([&](){ writeFile.close(); });
+	uint32 sections = writeIndex.size();
+	size_t indexSize = sizeof(sections) + sections * sizeof(StateSection);
+	std::vector<char> data(indexSize + writeData.size());
+	memcpy(data.data(), &sections, sizeof(sections));
+	for(auto &s : writeIndex)
+	{
+		s.offset += indexSize;
+	}
+	memcpy(data.data() + sizeof(sections), writeIndex.data(), sections * sizeof(StateSection));
+	memcpy(data.data() + indexSize, writeData.data(), writeData.size());
+	writeIndex = {};
+	writeData = {};
+
+	StateFileHeader header{};
+	memcpy(header.magic, stateMagic, sizeof(stateMagic));
+	header.version = STATE_FORMAT_VERSION;
+	header.dataSize = data.size();
+	#ifndef MSX_STATE_NO_COMPRESSION
+	std::vector<char> stored(compressBound(data.size()));
+	uLongf storedSize = stored.size();
+	if(compress2((Bytef*)stored.data(), &storedSize, (const Bytef*)data.data(), data.size(), Z_BEST_SPEED) != Z_OK)
+	{
+		logErr("error deflating state data");
+		return IO_ERROR;
+	}
+	stored.resize(storedSize);
+	header.flags = STATE_FLAG_DEFLATE;
+	#else
+	auto &stored = data;
+	#endif
+	header.storedSize = stored.size();
+	if(writeFile.writeAll(&header, sizeof(header))
+		|| writeFile.writeAll(stored.data(), stored.size()))
+	{
+		logErr("error writing state file");
+		return IO_ERROR;
+	}
+	return OK;
 }
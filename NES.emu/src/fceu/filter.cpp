@@ -12,9 +12,16 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 
-static int32 sq2coeffs[SQ2NCOEFFS];
-static int32 coeffs[NCOEFFS];
+#if defined(__GNUC__) && !defined(FCEU_NO_SIMD_FILTER)
+#define FCEU_SIMD_FILTER
+typedef int32 v4i32 __attribute__((vector_size(16)));
+typedef uint32 v4u32 __attribute__((vector_size(16)));
+#endif
+
+static int32 sq2coeffs[SQ2NCOEFFS] __attribute__((aligned(16)));
+static int32 coeffs[NCOEFFS] __attribute__((aligned(16)));
 
 static uint32 mrindex;
 static uint32 mrratio;
@@ -81,6 +88,38 @@ void SexyFilter(int32 *in, int32 *out, int32 count)
  }
 }
 
+/* Runs the FIR for one output sample, acc over in[1..ncoeffs] and acc2 over
+   in[2..ncoeffs+1]. The taps are symmetric, so walking them forwards gives
+   the same terms as the original reversed loop, and since each term is
+   shifted before the (wrapping) sum, any summing order is bit-exact. */
+static inline void FIRSample(const int32 *in, const int32 *D, uint32 ncoeffs, int32 &accOut, int32 &acc2Out)
+{
+	const int32 *S=in+1;
+#ifdef FCEU_SIMD_FILTER
+	v4i32 acc={0,0,0,0},acc2={0,0,0,0};
+	for(uint32 c=0;c<ncoeffs;c+=4)
+	{
+		v4u32 d,s,s2;
+		memcpy(&d,&D[c],sizeof(d));
+		memcpy(&s,&S[c],sizeof(s));
+		memcpy(&s2,&S[c+1],sizeof(s2));
+		acc+=(v4i32)(s*d)>>6;
+		acc2+=(v4i32)(s2*d)>>6;
+	}
+	accOut=(uint32)acc[0]+acc[1]+acc[2]+acc[3];
+	acc2Out=(uint32)acc2[0]+acc2[1]+acc2[2]+acc2[3];
+#else
+	uint32 acc=0,acc2=0;
+	for(uint32 c=0;c<ncoeffs;c++)
+	{
+		acc+=(int32)((uint32)S[c]*D[c])>>6;
+		acc2+=(int32)((uint32)S[c+1]*D[c])>>6;
+	}
+	accOut=acc;
+	acc2Out=acc2;
+#endif
+}
+
 /* Returns number of samples written to out. */
 /* leftover is set to the number of samples that need to be copied
    from the end of in to the beginning of in.
@@ -109,15 +148,9 @@ int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover)
 	if(FSettings.soundq==2)
         for(x=mrindex;x<max;x+=mrratio)
         {
-			int32 acc=0,acc2=0;
-			unsigned int c;
-			int32 *S,*D;
+			int32 acc,acc2;
 
-			for(c=SQ2NCOEFFS,S=&in[(x>>16)-SQ2NCOEFFS],D=sq2coeffs;c;c--,D++)
-			{
-				acc+=(S[c]**D)>>6;
-				acc2+=(S[1+c]**D)>>6;
-			}
+			FIRSample(&in[(x>>16)-SQ2NCOEFFS],sq2coeffs,SQ2NCOEFFS,acc,acc2);
 
 			acc=((int64)acc*(65536-(x&65535))+(int64)acc2*(x&65535))>>(16+11);
 			*out=acc;
@@ -127,15 +160,9 @@ int32 NeoFilterSound(int32 *in, int32 *out, uint32 inlen, int32 *leftover)
 	else
 		for(x=mrindex;x<max;x+=mrratio)
 		{
-			int32 acc=0,acc2=0;
-			unsigned int c;
-			const int32 *S,*D;
-
-			for(c=NCOEFFS,S=&in[(x>>16)-NCOEFFS],D=coeffs;c;c--,D++)
-			{
-				acc+=(S[c]**D)>>6;
-				acc2+=(S[1+c]**D)>>6;
-			}
+			int32 acc,acc2;
+
+			FIRSample(&in[(x>>16)-NCOEFFS],coeffs,NCOEFFS,acc,acc2);
 
 			acc=((int64)acc*(65536-(x&65535))+(int64)acc2*(x&65535))>>(16+11);
 			*out=acc;
@@ -72,6 +72,17 @@ static uint32 ppulut1[256];
 static uint32 ppulut2[256];
 static uint32 ppulut3[128];
 
+//Decoded background tile rows for CHR chip 0, ppulut1[lo] | ppulut2[hi] for
+//every row of every tile. Keyed by offset into the chip, so bank switches
+//don't affect it; CHR RAM and CHR-backed nametable writes through $2007
+//update it, and power, reset, state loads and direct writes into the chip
+//rebuild it through FCEUPPU_InvalidateCHRCache().
+static uint32 *chrrowcache = 0;
+static uint8 *chrrowcachebase = 0;
+static uint32 chrrowcachechipsize = 0;
+static uint32 chrrowcachesize = 0;
+static int chrrowcachestale = 1;
+
 static bool new_ppu_reset = false;
 
 int test = 0;
@@ -323,6 +334,47 @@ static void makeppulut(void) {
 	}
 }
 
+static void BuildCHRRowCache(void) {
+	uint32 x;
+
+	chrrowcachestale = 0;
+	chrrowcachebase = CHRptr[0];
+	if (chrrowcachechipsize != CHRsize[0]) {
+		if (chrrowcache)
+			FCEU_free(chrrowcache);
+		chrrowcachechipsize = CHRsize[0];
+		chrrowcache = CHRsize[0] ? (uint32*)FCEU_malloc((CHRsize[0] >> 1) * sizeof(uint32)) : 0;
+		chrrowcachesize = chrrowcache ? CHRsize[0] & ~0xF : 0;
+	}
+
+	for (x = 0; x < chrrowcachesize; x += 16) {
+		uint8 *C = chrrowcachebase + x;
+		uint32 *row = chrrowcache + (x >> 1);
+		int y;
+		for (y = 0; y < 8; y++)
+			row[y] = ppulut1[C[y]] | ppulut2[C[y + 8]];
+	}
+}
+
+static INLINE uint32 CHRRowCacheGet(uint8 *C) {
+	uint32 ofs = C - chrrowcachebase;
+	if (ofs < chrrowcachesize)
+		return chrrowcache[((ofs >> 1) & ~7) | (ofs & 7)];
+	return ppulut1[C[0]] | ppulut2[C[8]];
+}
+
+void FCEUPPU_InvalidateCHRCache(void) {
+	chrrowcachestale = 1;
+}
+
+static INLINE void CHRRowCacheWrite(uint8 *C) {
+	uint32 ofs = C - chrrowcachebase;
+	if (chrrowcachestale || chrrowcachebase != CHRptr[0] || ofs >= chrrowcachesize)
+		return;
+	ofs &= ~8;
+	chrrowcache[((ofs >> 1) & ~7) | (ofs & 7)] = ppulut1[chrrowcachebase[ofs]] | ppulut2[chrrowcachebase[ofs + 8]];
+}
+
 static int ppudead = 1;
 static int kook = 0;
 int fceuindbg = 0;
@@ -413,11 +465,15 @@ inline void FFCEUX_PPUWrite_Default(uint32 A, uint8 V) {
 	if (PPU_hook) PPU_hook(A);
 
 	if (tmp < 0x2000) {
-		if (PPUCHRRAM & (1 << (tmp >> 10)))
+		if (PPUCHRRAM & (1 << (tmp >> 10))) {
 			VPage[tmp >> 10][tmp] = V;
+			CHRRowCacheWrite(&VPage[tmp >> 10][tmp]);
+		}
 	} else if (tmp < 0x3F00) {
-		if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10)))
+		if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10))) {
 			vnapage[((tmp & 0xF00) >> 10)][tmp & 0x3FF] = V;
+			CHRRowCacheWrite(&vnapage[((tmp & 0xF00) >> 10)][tmp & 0x3FF]);
+		}
 	} else {
 		if (!(tmp & 3)) {
 			if (!(tmp & 0xC))
@@ -940,11 +996,15 @@ static DECLFW(B2007) {
 	} else {
 		PPUGenLatch = V;
 		if (tmp < 0x2000) {
-			if (PPUCHRRAM & (1 << (tmp >> 10)))
+			if (PPUCHRRAM & (1 << (tmp >> 10))) {
 				VPage[tmp >> 10][tmp] = V;
+				CHRRowCacheWrite(&VPage[tmp >> 10][tmp]);
+			}
 		} else if (tmp < 0x3F00) {
-			if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10)))
+			if (PPUNTARAM & (1 << ((tmp & 0xF00) >> 10))) {
 				vnapage[((tmp & 0xF00) >> 10)][tmp & 0x3FF] = V;
+				CHRRowCacheWrite(&vnapage[((tmp & 0xF00) >> 10)][tmp & 0x3FF]);
+			}
 		} else {
 			if (!(tmp & 3)) {
 				if (!(tmp & 0xC))
@@ -1055,6 +1115,7 @@ static int spork = 0;
 // lasttile is really "second to last tile."
 static void RefreshLine(int lastpixel) {
 	static uint32 pshift[2];
+	static uint32 prow[2];
 	static uint32 atlatch;
 	uint32 smorkus = RefreshAddr;
 
@@ -1185,9 +1246,13 @@ static void RefreshLine(int lastpixel) {
 			}
 			#undef PPU_BGFETCH
 		} else {
+			if (chrrowcachestale || chrrowcachebase != CHRptr[0] || chrrowcachechipsize != CHRsize[0])
+				BuildCHRRowCache();
+			#define PPUT_CHRCACHE
 			for (X1 = firsttile; X1 < lasttile; X1++) {
 				#include "pputile.inc"
 			}
+			#undef PPUT_CHRCACHE
 		}
 	}
 
@@ -1730,6 +1795,7 @@ void FCEUPPU_Reset(void) {
 	ppudead = 2;
 	kook = 0;
 	idleSynch = 1;
+	chrrowcachestale = 1;
 
 	new_ppu_reset = true; // delay reset of ppur/spr_read until it's ready to start a new frame
 }
@@ -1919,6 +1985,7 @@ static uint16 TempAddrT, RefreshAddrT;
 void FCEUPPU_LoadState(int version) {
 	TempAddr = TempAddrT;
 	RefreshAddr = RefreshAddrT;
+	chrrowcachestale = 1;
 }
 
 SFORMAT FCEUPPU_STATEINFO[] = {
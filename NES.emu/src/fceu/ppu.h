@@ -20,6 +20,7 @@ extern uint8 PPUCHRRAM;
 
 void FCEUPPU_SaveState(void);
 void FCEUPPU_LoadState(int version);
+void FCEUPPU_InvalidateCHRCache(void);
 uint32 FCEUPPU_PeekAddress();
 uint8* FCEUPPU_GetCHR(uint32 vadr, uint32 refreshaddr);
 int FCEUPPU_GetAttr(int ntnum, int xt, int yt);
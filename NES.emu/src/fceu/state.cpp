@@ -599,6 +599,8 @@ int FCEUSS_LoadFP_old(EMUFILE* is, ENUM_SSLOADPARAMS params)
 	{
 		X.IRQlow=0;
 	}
+	// chunks may have landed in CHR RAM even if the load failed
+	FCEUPPU_InvalidateCHRCache();
 	if(GameStateRestore)
 	{
 		GameStateRestore(stateversion);
@@ -691,6 +693,8 @@ bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params)
 	//if(read_sfcpuc && stateversion<9500)
 	//	X.IRQlow=0;
 
+	// chunks may have landed in CHR RAM even if the load failed
+	FCEUPPU_InvalidateCHRCache();
 	if(GameStateRestore)
 	{
 		GameStateRestore(stateversion);
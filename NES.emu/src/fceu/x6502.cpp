@@ -304,36 +304,36 @@ static uint8 ZNTable[256];
    redundant) on the variable "x".
 */
 
-#define RMW_A(op) {uint8 x=_A; op; _A=x; break; } /* Meh... */
-#define RMW_AB(op) {unsigned int A; uint8 x; GetAB(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); break; }
-#define RMW_ABI(reg,op) {unsigned int A; uint8 x; GetABIWR(A,reg); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); break; }
+#define RMW_A(op) {uint8 x=_A; op; _A=x; OP_END; } /* Meh... */
+#define RMW_AB(op) {unsigned int A; uint8 x; GetAB(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); OP_END; }
+#define RMW_ABI(reg,op) {unsigned int A; uint8 x; GetABIWR(A,reg); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); OP_END; }
 #define RMW_ABX(op)  RMW_ABI(X.X,op)
 #define RMW_ABY(op)  RMW_ABI(_Y,op)
-#define RMW_IX(op)  {unsigned int A; uint8 x; GetIX(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); break; }
-#define RMW_IY(op)  {unsigned int A; uint8 x; GetIYWR(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); break; }
-#define RMW_ZP(op)  {uint8 A; uint8 x; GetZP(A); x=RdRAM(A); op; WrRAM(A,x); break; }
-#define RMW_ZPX(op) {uint8 A; uint8 x; GetZPI(A,X.X); x=RdRAM(A); op; WrRAM(A,x); break;}
-
-#define LD_IM(op)  {uint8 x; x=RdMem(_PC); _PC++; op; break;}
-#define LD_ZP(op)  {uint8 A; uint8 x; GetZP(A); x=RdRAM(A); op; break;}
-#define LD_ZPX(op)  {uint8 A; uint8 x; GetZPI(A,X.X); x=RdRAM(A); op; break;}
-#define LD_ZPY(op)  {uint8 A; uint8 x; GetZPI(A,_Y); x=RdRAM(A); op; break;}
-#define LD_AB(op)  {unsigned int A; uint8 x; GetAB(A); x=RdMem(A); op; break; }
-#define LD_ABI(reg,op)  {unsigned int A; uint8 x; GetABIRD(A,reg); x=RdMem(A); op; break;}
+#define RMW_IX(op)  {unsigned int A; uint8 x; GetIX(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); OP_END; }
+#define RMW_IY(op)  {unsigned int A; uint8 x; GetIYWR(A); x=RdMem(A); WrMem(A,x); op; WrMem(A,x); OP_END; }
+#define RMW_ZP(op)  {uint8 A; uint8 x; GetZP(A); x=RdRAM(A); op; WrRAM(A,x); OP_END; }
+#define RMW_ZPX(op) {uint8 A; uint8 x; GetZPI(A,X.X); x=RdRAM(A); op; WrRAM(A,x); OP_END;}
+
+#define LD_IM(op)  {uint8 x; x=RdMem(_PC); _PC++; op; OP_END;}
+#define LD_ZP(op)  {uint8 A; uint8 x; GetZP(A); x=RdRAM(A); op; OP_END;}
+#define LD_ZPX(op)  {uint8 A; uint8 x; GetZPI(A,X.X); x=RdRAM(A); op; OP_END;}
+#define LD_ZPY(op)  {uint8 A; uint8 x; GetZPI(A,_Y); x=RdRAM(A); op; OP_END;}
+#define LD_AB(op)  {unsigned int A; uint8 x; GetAB(A); x=RdMem(A); op; OP_END; }
+#define LD_ABI(reg,op)  {unsigned int A; uint8 x; GetABIRD(A,reg); x=RdMem(A); op; OP_END;}
 #define LD_ABX(op)  LD_ABI(X.X,op)
 #define LD_ABY(op)  LD_ABI(_Y,op)
-#define LD_IX(op)  {unsigned int A; uint8 x; GetIX(A); x=RdMem(A); op; break;}
-#define LD_IY(op)  {unsigned int A; uint8 x; GetIYRD(A); x=RdMem(A); op; break;}
-
-#define ST_ZP(r)  {uint8 A; GetZP(A); WrRAM(A,r); break;}
-#define ST_ZPX(r)  {uint8 A; GetZPI(A,X.X); WrRAM(A,r); break;}
-#define ST_ZPY(r)  {uint8 A; GetZPI(A,_Y); WrRAM(A,r); break;}
-#define ST_AB(r)  {unsigned int A; GetAB(A); WrMem(A,r); break;}
-#define ST_ABI(reg,r)  {unsigned int A; GetABIWR(A,reg); WrMem(A,r); break; }
+#define LD_IX(op)  {unsigned int A; uint8 x; GetIX(A); x=RdMem(A); op; OP_END;}
+#define LD_IY(op)  {unsigned int A; uint8 x; GetIYRD(A); x=RdMem(A); op; OP_END;}
+
+#define ST_ZP(r)  {uint8 A; GetZP(A); WrRAM(A,r); OP_END;}
+#define ST_ZPX(r)  {uint8 A; GetZPI(A,X.X); WrRAM(A,r); OP_END;}
+#define ST_ZPY(r)  {uint8 A; GetZPI(A,_Y); WrRAM(A,r); OP_END;}
+#define ST_AB(r)  {unsigned int A; GetAB(A); WrMem(A,r); OP_END;}
+#define ST_ABI(reg,r)  {unsigned int A; GetABIWR(A,reg); WrMem(A,r); OP_END; }
 #define ST_ABX(r)  ST_ABI(X.X,r)
 #define ST_ABY(r)  ST_ABI(_Y,r)
-#define ST_IX(r)  {unsigned int A; GetIX(A); WrMem(A,r); break; }
-#define ST_IY(r)  {unsigned int A; GetIYWR(A); WrMem(A,r); break; }
+#define ST_IX(r)  {unsigned int A; GetIX(A); WrMem(A,r); OP_END; }
+#define ST_IY(r)  {unsigned int A; GetIYWR(A); WrMem(A,r); OP_END; }
 
 static uint8 CycTable[256] =
 {
@@ -415,8 +415,72 @@ void X6502_Power(void)
  X6502_Reset();
 }
 
+//threaded dispatch: each opcode ends by fetching the next one and jumping
+//straight to its label through opTable, instead of going back to a single
+//switch. The fetch and hooks are the same as the switch loop, so timing is
+//unchanged. It's used by default on ARM where the single indirect branch of
+//the switch predicts poorly, define X6502_THREADED_DISPATCH or
+//X6502_SWITCH_DISPATCH to choose one elsewhere.
+#if defined(__GNUC__) && (defined(__arm__) || defined(__aarch64__)) && !defined(X6502_SWITCH_DISPATCH)
+#define X6502_THREADED_DISPATCH
+#endif
+
+#ifdef _S9XLUA_H
+#define X6502_EXEC_HOOK() CallRegisteredLuaMemHook(_PC, 1, 0, LUAMEMHOOK_EXEC)
+#else
+#define X6502_EXEC_HOOK()
+#endif
+
+#ifdef X6502_THREADED_DISPATCH
+#define OP(n) op_##n
+#define OP_PREFETCH(b) opTarget=opTable[b]
+#define OP_END \
+{ \
+ if(_count<=0 || _IRQlow) continue; \
+ DEBUG( DebugCycle() ); \
+ X6502_FETCH(); \
+ goto *opTarget; \
+}
+#define OP_ROW(h) \
+ &&op_0x##h##0, &&op_0x##h##1, &&op_0x##h##2, &&op_0x##h##3, \
+ &&op_0x##h##4, &&op_0x##h##5, &&op_0x##h##6, &&op_0x##h##7, \
+ &&op_0x##h##8, &&op_0x##h##9, &&op_0x##h##A, &&op_0x##h##B, \
+ &&op_0x##h##C, &&op_0x##h##D, &&op_0x##h##E, &&op_0x##h##F
+#else
+#define OP(n) case n
+#define OP_PREFETCH(b)
+#define OP_END break
+#endif
+
+//the target of the next opcode is looked up before the hooks run
+#define X6502_FETCH() \
+{ \
+ _PI=X.P; \
+ b1=RdMem(_PC); \
+ OP_PREFETCH(b1); \
+ ADDCYC(CycTable[b1]); \
+ temp=_tcount; \
+ _tcount=0; \
+ if(MapIRQHook) MapIRQHook(temp); \
+ if (!overclocking) \
+  FCEU_SoundCPUHook(temp); \
+ X6502_EXEC_HOOK(); \
+ _PC++; \
+}
+
 void X6502_Run(int32 cycles)
 {
+#ifdef X6502_THREADED_DISPATCH
+  static const void *const opTable[256] =
+  {
+   OP_ROW(0), OP_ROW(1), OP_ROW(2), OP_ROW(3),
+   OP_ROW(4), OP_ROW(5), OP_ROW(6), OP_ROW(7),
+   OP_ROW(8), OP_ROW(9), OP_ROW(A), OP_ROW(B),
+   OP_ROW(C), OP_ROW(D), OP_ROW(E), OP_ROW(F)
+  };
+  const void *opTarget;
+#endif
+
   if(PAL)
    cycles*=15;    // 15*4=60
   else
@@ -488,25 +552,18 @@ extern int test; test++;
 
    //IncrementInstructionsCounters();
 
-   _PI=X.P;
-   b1=RdMem(_PC);
-
-   ADDCYC(CycTable[b1]);
-
-   temp=_tcount;
-   _tcount=0;
-   if(MapIRQHook) MapIRQHook(temp);
-   
-   if (!overclocking)
-    FCEU_SoundCPUHook(temp);
-   #ifdef _S9XLUA_H
-   CallRegisteredLuaMemHook(_PC, 1, 0, LUAMEMHOOK_EXEC);
-   #endif
-   _PC++;
+   X6502_FETCH();
+#ifdef X6502_THREADED_DISPATCH
+   goto *opTarget;
+   {
+    #include "ops.inc"
+   }
+#else
    switch(b1)
    {
     #include "ops.inc"
    }
+#endif
   }
 }
 
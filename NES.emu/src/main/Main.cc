@@ -138,6 +138,14 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 		return {};
 }
 
+uint EmuSystem::memSearchRegions(MemSearchRegion (&region)[MAX_MEM_SEARCH_REGIONS])
+{
+	if(!gameIsRunning() || !RAM)
+		return 0;
+	region[0] = {RAM, 0x800, 0x0000, false};
+	return 1;
+}
+
 void EmuSystem::saveBackupMem() // for manually saving when not closing game
 {
 	if(gameIsRunning())
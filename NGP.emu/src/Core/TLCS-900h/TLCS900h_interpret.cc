@@ -943,8 +943,264 @@ static void (*decode[256])() =
 
 //=============================================================================
 
+#ifndef TLCS900H_NO_DECODE_CACHE
+
+//Decoded instruction cache. An entry holds what the decode tables resolve
+//for the opcode bytes at one pc: the final handler, operand size, register
+//code and how to form the effective address, so executing it again skips
+//refetching and redispatching those bytes. Entries keep a copy of the bytes
+//and are compared against memory before use, which covers CPU, DMA and Z80
+//writes, flash writes and state loads without hooks in each of them.
+
+enum
+{
+	DMEM_NONE,		//no address mode, mem is left as is
+	DMEM_REG,		//mem = regL(reg) + disp
+	DMEM_ABS,		//mem = disp
+	DMEM_RCODE,		//mem = rCodeL(reg) + disp
+	DMEM_RCODE_B,	//mem = rCodeL(reg) + (int8)rCodeB(idx)
+	DMEM_RCODE_W,	//mem = rCodeL(reg) + (int16)rCodeW(idx)
+	DMEM_PREDEC,	//rCodeL(reg) -= disp, mem = rCodeL(reg)
+	DMEM_POSTINC,	//mem = rCodeL(reg), rCodeL(reg) += disp
+};
+
+enum
+{
+	DOP_SINGLE,		//first byte only
+	DOP_SRC,		//sets second, R and size
+	DOP_DST,		//sets second and R
+	DOP_REG,		//sets second, R and size
+};
+
+struct DecodedOp
+{
+	uint32 pc;
+	uint32 disp;
+	const uint8* code;
+	uint64 bytes;
+	void (*handler)();
+	uint8 length, kind, memMode, reg, idx;
+	uint8 first, second, size, rCode, cyclesExtra;
+	bool brCode;
+};
+
+#define DECODE_CACHE_SIZE 8192
+#define DECODE_MAX_LENGTH 8
+
+static DecodedOp decodeCache[DECODE_CACHE_SIZE];
+
+void flush_decode_cache(void)
+{
+	for (int i = 0; i < DECODE_CACHE_SIZE; i++)
+		decodeCache[i].pc = 0xFFFFFFFF;
+}
+
+static inline uint64 decodeBytes(const uint8* code, uint8 length)
+{
+	uint64 v;
+	memcpy(&v, code, sizeof(v));
+#ifndef LSB_FIRST
+	v = __builtin_bswap64(v);
+#endif
+	return length == 8 ? v : v & ((uint64(1) << (length * 8)) - 1);
+}
+
+//Mirrors the table walk in TLCS900h_interpret() without executing anything,
+//returns false for encodings that can't be described by a DecodedOp
+static bool decodeOp(DecodedOp& op, uint32 opPC)
+{
+	const uint8* code = translate_address_code(opPC, DECODE_MAX_LENGTH);
+	if (!code)
+		return false;
+
+	uint8 len = 0;
+	uint8 first = code[len++];
+
+	op.first = first;
+	op.memMode = DMEM_NONE;
+	op.cyclesExtra = 0;
+	op.disp = 0;
+	op.reg = op.idx = 0;
+	op.rCode = 0;
+
+	op.brCode = FALSE;
+	void (*extra)() = decodeExtra[first];
+
+	if (extra == ExXWA || extra == ExXBC || extra == ExXDE || extra == ExXHL
+		|| extra == ExXIX || extra == ExXIY || extra == ExXIZ || extra == ExXSP)
+	{
+		op.memMode = DMEM_REG;
+		op.reg = first & 7;
+	}
+	else if (extra == ExXWAd || extra == ExXBCd || extra == ExXDEd || extra == ExXHLd
+		|| extra == ExXIXd || extra == ExXIYd || extra == ExXIZd || extra == ExXSPd)
+	{
+		op.memMode = DMEM_REG;
+		op.reg = first & 7;
+		op.disp = (int8)code[len++];
+		op.cyclesExtra = 2;
+	}
+	else if (extra == Ex8)
+	{
+		op.memMode = DMEM_ABS;
+		op.disp = code[len++];
+		op.cyclesExtra = 2;
+	}
+	else if (extra == Ex16)
+	{
+		op.memMode = DMEM_ABS;
+		op.disp = code[len] | (code[len + 1] << 8);
+		len += 2;
+		op.cyclesExtra = 2;
+	}
+	else if (extra == Ex24)
+	{
+		op.memMode = DMEM_ABS;
+		op.disp = code[len] | (code[len + 1] << 8) | (code[len + 2] << 16);
+		len += 3;
+		op.cyclesExtra = 3;
+	}
+	else if (extra == ExR32)
+	{
+		uint8 data = code[len++];
+
+		if (data == 0x03 || data == 0x07)
+		{
+			op.memMode = data == 0x03 ? DMEM_RCODE_B : DMEM_RCODE_W;
+			op.reg = code[len++];
+			op.idx = code[len++];
+			op.cyclesExtra = 8;
+		}
+		else if (data == 0x13)
+		{
+			return false;	//pc relative, rare enough to leave to the tables
+		}
+		else
+		{
+			op.memMode = DMEM_RCODE;
+			op.reg = data;
+			op.cyclesExtra = 5;
+			if ((data & 3) == 1)
+			{
+				op.disp = (int16)(code[len] | (code[len + 1] << 8));
+				len += 2;
+			}
+		}
+	}
+	else if (extra == ExDec || extra == ExInc)
+	{
+		uint8 data = code[len++];
+
+		op.cyclesExtra = 3;
+		if ((data & 3) != 3)
+		{
+			op.memMode = extra == ExDec ? DMEM_PREDEC : DMEM_POSTINC;
+			op.reg = data & 0xFC;
+			op.disp = 1 << (data & 3);
+		}
+	}
+	else if (extra == ExRC)
+	{
+		op.brCode = TRUE;
+		op.rCode = code[len++];
+		op.cyclesExtra = 1;
+	}
+	else if (extra)
+	{
+		return false;
+	}
+
+	void (*primary)() = decode[first];
+
+	if (primary == src_B || primary == src_W || primary == src_L)
+	{
+		op.kind = DOP_SRC;
+		op.second = code[len++];
+		op.size = primary == src_B ? 0 : primary == src_W ? 1 : 2;
+		op.handler = srcDecode[op.second];
+	}
+	else if (primary == dst)
+	{
+		op.kind = DOP_DST;
+		op.second = code[len++];
+		op.handler = dstDecode[op.second];
+	}
+	else if (primary == reg_B || primary == reg_W || primary == reg_L)
+	{
+		op.kind = DOP_REG;
+		op.second = code[len++];
+		op.size = primary == reg_B ? 0 : primary == reg_W ? 1 : 2;
+		if (!op.brCode)
+		{
+			op.brCode = TRUE;
+			op.rCode = primary == reg_B ? rCodeConversionB[first & 7]
+				: primary == reg_W ? rCodeConversionW[first & 7] : rCodeConversionL[first & 7];
+		}
+		op.handler = regDecode[op.second];
+	}
+	else
+	{
+		op.kind = DOP_SINGLE;
+		op.handler = primary;
+	}
+
+	op.pc = opPC;
+	op.code = code;
+	op.length = len;
+	op.bytes = decodeBytes(code, len);
+	return true;
+}
+
+#else
+
+void flush_decode_cache(void) { }
+
+#endif
+
 uint32 TLCS900h_interpret(void)
 {
+#ifndef TLCS900H_NO_DECODE_CACHE
+	DecodedOp& op = decodeCache[pc & (DECODE_CACHE_SIZE - 1)];
+
+	//A pending EEPROM status read changes what the next fetch returns
+	if (!eepromStatusEnable
+		&& ((op.pc == pc && decodeBytes(op.code, op.length) == op.bytes) || decodeOp(op, pc)))
+	{
+		first = op.first;
+		brCode = op.brCode;
+		if (brCode)
+			rCode = op.rCode;
+		cycles_extra = op.cyclesExtra;
+
+		switch (op.memMode)
+		{
+		case DMEM_NONE:		break;
+		case DMEM_REG:		mem = regL(op.reg) + op.disp;	break;
+		case DMEM_ABS:		mem = op.disp;	break;
+		case DMEM_RCODE:	mem = rCodeL(op.reg) + op.disp;	break;
+		case DMEM_RCODE_B:	mem = rCodeL(op.reg) + (int8)rCodeB(op.idx);	break;
+		case DMEM_RCODE_W:	mem = rCodeL(op.reg) + (int16)rCodeW(op.idx);	break;
+		case DMEM_PREDEC:	rCodeL(op.reg) -= op.disp;	mem = rCodeL(op.reg);	break;
+		case DMEM_POSTINC:	mem = rCodeL(op.reg);	rCodeL(op.reg) += op.disp;	break;
+		}
+
+		if (op.kind != DOP_SINGLE)
+		{
+			second = op.second;
+			R = second & 7;
+			if (op.kind != DOP_DST)
+				size = op.size;
+		}
+
+		pc = op.pc + op.length;
+		(*op.handler)();
+
+		return cycles + cycles_extra;
+	}
+
+	op.pc = 0xFFFFFFFF;
+#endif
+
 	brCode = FALSE;
 
 	first = FETCH8;	//Get the first byte
@@ -49,6 +49,9 @@
 //Returns the number of cycles taken for this instruction
 uint32 TLCS900h_interpret(void) __attribute__ ((hot));
 
+//Drops all decoded instructions, call when the memory map changes
+void flush_decode_cache(void);
+
 //=============================================================================
 
 extern uint32 mem;
@@ -37,6 +37,7 @@
 
 #include "neopop.h"
 #include "TLCS900h_registers.h"
+#include "TLCS900h_interpret.h"
 
 #ifdef MSB_FIRST
 #define BYTE0	3
@@ -193,6 +194,8 @@ void reset_registers(void)
 
 	REGXSP = 0x00006C00; //Confirmed from BIOS, 
 						//immediately changes value from default of 0x100
+
+	flush_decode_cache();
 }
 
 //=============================================================================
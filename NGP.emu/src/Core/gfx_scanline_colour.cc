@@ -69,6 +69,19 @@ and compatiblity reasons.
 #include <imagine/util/algorithm.h>
 #include <imagine/util/bits.h>
 #include <algorithm>
+#ifdef NGP_GFX_CHECK_SIMD
+#include <imagine/logger/logger.h>
+#include <chrono>
+#endif
+
+// Tiles are drawn 8 pixels at a time with GCC vector extensions (NEON on ARM),
+// define NGP_GFX_CHECK_SIMD to also render each line with the scalar loop and
+// compare the output and per line cost
+#if defined(__GNUC__) && !defined(NGP_GFX_NO_SIMD)
+#define NGP_GFX_SIMD
+typedef uint16 v8u16 __attribute__((vector_size(16)));
+typedef uint8 v8u8 __attribute__((vector_size(8)));
+#endif
 
 //=============================================================================
 
@@ -139,6 +152,51 @@ void gfx_buildColorConvMap()
 	}
 }
 
+#ifdef NGP_GFX_SIMD
+
+//Draws the pixels of one tile row between left and right, x must not be negative
+static void drawPatternLanes(int x, int left, int right, uint16 index, uint16 mirror,
+				 const uint16* palette_ptr, uint8 depth)
+{
+	//2bpp expansion, pixel 0 is in the top bits unless the tile is flipped,
+	//in which case the lane order is reversed
+	static const v8u16 pixelShift = { 14, 12, 10, 8, 6, 4, 2, 0 };
+	static const v8u16 mirrorShift = { 0, 2, 4, 6, 8, 10, 12, 14 };
+	static const v8u16 lane = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+	v8u16 code = ((v8u16){} + index) >> (mirror ? mirrorShift : pixelShift);
+	code &= 3;
+
+	//Colour conversion for the 3 opaque palette entries
+	uint16 invert = negative ? 0xFFFF : 0;
+	v8u16 colour = ((v8u16)(code == 1) & (uint16)(colorConvMap[le16toh(palette_ptr[1])] ^ invert))
+		| ((v8u16)(code == 2) & (uint16)(colorConvMap[le16toh(palette_ptr[2])] ^ invert))
+		| ((v8u16)(code == 3) & (uint16)(colorConvMap[le16toh(palette_ptr[3])] ^ invert));
+
+	//Depth compare, window clip and transparency
+	v8u8 z8;
+	memcpy(&z8, zbuffer + x, sizeof(z8));
+	v8u16 z = __builtin_convertvector(z8, v8u16);
+	v8u16 px = lane + (uint16)x;
+	v8u16 draw = (v8u16)(code != 0) & (v8u16)(z < depth)
+		& (v8u16)(px >= (uint16)left) & (v8u16)(px <= (uint16)right);
+
+	z = (z & ~draw) | (draw & depth);
+	z8 = __builtin_convertvector(z, v8u8);
+	memcpy(zbuffer + x, &z8, sizeof(z8));
+
+	v8u16 out;
+	memcpy(&out, cfb_scanline + x, sizeof(out));
+	out = (out & ~draw) | (colour & draw);
+	memcpy(cfb_scanline + x, &out, sizeof(out));
+}
+
+#endif
+
+#ifdef NGP_GFX_CHECK_SIMD
+static bool scalarPatterns;
+#endif
+
 static void drawPattern(uint8 screenx, uint16 tile, uint8 tiley, uint16 mirror,
 				 uint16* palette_ptr, uint8 pal, uint8 depth)
 {
@@ -155,9 +213,9 @@ static void drawPattern(uint8 screenx, uint16 tile, uint8 tiley, uint16 mirror,
 	//Get the data for the "tiley'th" line of "tile".
 	index = le16toh(*(uint16*)(ram + 0xA000 + (tile * 16) + (tiley * 2)));
 
-	//Horizontal Flip
-	if (mirror)
-		index = mirrored[(index & 0xff00)>>8] | (mirrored[(index & 0xff)] << 8);
+	//Fully transparent
+	if (!index)
+		return;
 
 	palette_ptr += pal << 2;
 	left = std::max(std::max(x, (int)winx), 0);
@@ -165,6 +223,22 @@ static void drawPattern(uint8 screenx, uint16 tile, uint8 tiley, uint16 mirror,
 
 	highmark = std::min(winw+winx, SCREEN_WIDTH)-1;
 
+#ifdef NGP_GFX_SIMD
+	#ifdef NGP_GFX_CHECK_SIMD
+	if (x >= 0 && !scalarPatterns)
+	#else
+	if (x >= 0)
+	#endif
+	{
+		drawPatternLanes(x, left, std::min(right, highmark), index, mirror, palette_ptr, depth);
+		return;
+	}
+#endif
+
+	//Horizontal Flip
+	if (mirror)
+		index = mirrored[(index & 0xff00)>>8] | (mirrored[(index & 0xff)] << 8);
+
 	if (right > highmark) {
 		index >>= (right - highmark)*2;
 		right = highmark;
@@ -225,7 +299,11 @@ static void gfx_draw_scroll2(uint8 depth)
 	}
 }
 
+#ifdef NGP_GFX_CHECK_SIMD
+static void drawScanline(void)
+#else
 void gfx_draw_scanline_colour(void)
+#endif
 {
 	using namespace IG;
 	int16 lastSpriteX;
@@ -345,6 +423,44 @@ void gfx_draw_scanline_colour(void)
 
 }
 
+#ifdef NGP_GFX_CHECK_SIMD
+void gfx_draw_scanline_colour(void)
+{
+	static uint32 lines, mismatches;
+	static std::chrono::nanoseconds simdTime, scalarTime;
+	uint16 simdLine[SCREEN_WIDTH];
+	uint8 simdDepth[SCREEN_WIDTH];
+
+	auto start = std::chrono::steady_clock::now();
+	drawScanline();
+	auto mid = std::chrono::steady_clock::now();
+	memcpy(simdLine, cfb_scanline, sizeof(simdLine));
+	memcpy(simdDepth, zbuffer, sizeof(simdDepth));
+
+	scalarPatterns = true;
+	auto scalarStart = std::chrono::steady_clock::now();
+	drawScanline();
+	auto end = std::chrono::steady_clock::now();
+	scalarPatterns = false;
+
+	simdTime += mid - start;
+	scalarTime += end - scalarStart;
+	if (memcmp(simdLine, cfb_scanline, sizeof(simdLine)) || memcmp(simdDepth, zbuffer, sizeof(simdDepth)))
+	{
+		mismatches++;
+		logMsg("SIMD scanline %d differs from scalar", scanline);
+	}
+
+	if (++lines == 152 * 60)
+	{
+		logMsg("avg line: SIMD %dns, scalar %dns, %d mismatches",
+			int(simdTime.count() / lines), int(scalarTime.count() / lines), (int)mismatches);
+		lines = 0;
+		simdTime = scalarTime = {};
+	}
+}
+#endif
+
 #undef drawPattern
 #undef gfx_draw_scroll1
 #undef gfx_draw_scroll2
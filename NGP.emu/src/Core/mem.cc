@@ -216,6 +216,28 @@ void* translate_address_read(uint32 address)
 
 //=============================================================================
 
+const uint8* translate_address_code(uint32 address, uint32 length)
+{
+	//Work RAM only, the I/O and video areas below and above it have
+	//read side effects or change under the CPU every line
+	if (address >= 0x4000 && address + length <= 0x8000)
+		return ram + address;
+
+	if (rom.data && address >= ROM_START && address + length <= rom.realEnd
+		&& address + length <= ROM_END + 1)
+		return rom.data + (address & 0x1FFFFF);
+
+	if (rom.length > 0x200000 && address >= HIROM_START && address + length <= rom.realHEnd)
+		return rom.data + 0x200000 + (address - HIROM_START);
+
+	if (address >= BIOS_START && address + length <= BIOS_END + 1)
+		return bios + (address & 0xFFFF);
+
+	return NULL;
+}
+
+//=============================================================================
+
 void* translate_address_write(uint32 address)
 {	
 	address &= 0xFFFFFF;
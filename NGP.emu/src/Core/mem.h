@@ -57,6 +57,10 @@ void reset_memory(void);
 void* translate_address_read(uint32 address) __attribute__ ((hot));
 void* translate_address_write(uint32 address) __attribute__ ((hot));
 
+//Host pointer to 'length' bytes of plain ROM/BIOS/work RAM at 'address', for
+//caching decoded instructions. NULL if any of it has side effects on read.
+const uint8* translate_address_code(uint32 address, uint32 length);
+
 void dump_memory(uint32 start, uint32 length);
 
 extern bool debug_abort_memory;
@@ -369,6 +369,25 @@ void MDFND_commitVideoFrame(EmulateSpecStruct *espec)
 	}
 }
 
+#ifdef HUC6280_COUNT_INSTRUCTIONS
+// log the CPU's instructions per second every 180 frames, the length of a
+// Benchmark Game run
+static void logInstructionRate()
+{
+	static uint frames = 0;
+	static uint64 lastInstructions = 0;
+	static IG::Time lastTime = IG::Time::now();
+	if(++frames < 180)
+		return;
+	auto now = IG::Time::now();
+	auto instructions = PCE_Fast::HuCPU.instructions - lastInstructions;
+	logMsg("HuC6280: %.3f million instructions/sec", double(instructions) / double(now - lastTime) / 1000000.);
+	frames = 0;
+	lastInstructions = PCE_Fast::HuCPU.instructions;
+	lastTime = now;
+}
+#endif
+
 void EmuSystem::runFrame(EmuVideo *video, bool renderAudio)
 {
 	uint maxFrames = 48000/54;
@@ -391,6 +410,9 @@ void EmuSystem::runFrame(EmuVideo *video, bool renderAudio)
 	int32 lineWidth[242];
 	espec.LineWidths = lineWidth;
 	emuSys->Emulate(&espec);
+	#ifdef HUC6280_COUNT_INSTRUCTIONS
+	logInstructionRate();
+	#endif
 	if(renderAudio)
 	{
 		assert((uint)espec.SoundBufSize <= EmuSystem::pcmFormat.bytesToFrames(sizeof(audioBuff)));
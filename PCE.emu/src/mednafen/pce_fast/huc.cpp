@@ -214,6 +214,7 @@ uint32 HuC_Load(MDFNFILE* fp)
   {
    HuCPU.FastMap[x] = &ROMSpace[x * 8192];
    HuCPU.PCERead[x] = HuCRead;
+   HuCPU.BlockMoveFlags[x] = BMF_DIRECT_READ;
   }
 
   if(!memcmp(HuCROM + 0x1F26, "POPULOUS", strlen("POPULOUS")))
@@ -232,6 +233,7 @@ uint32 HuC_Load(MDFNFILE* fp)
     HuCPU.FastMap[x] = &PopRAM[(x & 3) * 8192];
     HuCPU.PCERead[x] = HuCRead;
     HuCPU.PCEWrite[x] = HuCRAMWrite;
+    HuCPU.BlockMoveFlags[x] = BMF_DIRECT_READ | BMF_DIRECT_WRITE;
    }
    MDFNMP_AddRAM(32768, 0x40 * 8192, PopRAM);
   }
@@ -255,6 +257,7 @@ uint32 HuC_Load(MDFNFILE* fp)
    for(int x = 0x40; x < 0x80; x++)
    {
     HuCPU.PCERead[x] = HuCSF2Read;
+    HuCPU.BlockMoveFlags[x] = 0;
    }
    HuCPU.PCEWrite[0] = HuCSF2Write;
    MDFN_printf("Street Fighter 2 Mapper\n");
@@ -312,6 +315,7 @@ void HuC_LoadCD(const std::string& bios_path)
   {
    HuCPU.FastMap[x] = &ROMSpace[x * 8192];
    HuCPU.PCERead[x] = HuCRead;
+   HuCPU.BlockMoveFlags[x] = BMF_DIRECT_READ;
   }
 
   for(int x = 0x68; x < 0x88; x++)
@@ -319,8 +323,10 @@ void HuC_LoadCD(const std::string& bios_path)
    HuCPU.FastMap[x] = &ROMSpace[x * 8192];
    HuCPU.PCERead[x] = HuCRead;
    HuCPU.PCEWrite[x] = HuCRAMWrite;
+   HuCPU.BlockMoveFlags[x] = BMF_DIRECT_READ | BMF_DIRECT_WRITE;
   }
   HuCPU.PCEWrite[0x80] = HuCRAMWriteCDSpecial; 	// Hyper Dyne Special hack
+  HuCPU.BlockMoveFlags[0x80] = BMF_DIRECT_READ;
   MDFNMP_AddRAM(262144, 0x68 * 8192, ROMSpace + 0x68 * 8192);
 
   if(PCE_ACEnabled)
@@ -331,6 +337,7 @@ void HuC_LoadCD(const std::string& bios_path)
    {
     HuCPU.PCERead[x] = ACPhysRead;
     HuCPU.PCEWrite[x] = ACPhysWrite;
+    HuCPU.BlockMoveFlags[x] = 0;
    }
   }
 
@@ -431,53 +431,148 @@ static INLINE uint8 RdOp(unsigned int A)
    redundant) on the variable "x".
 */
 
-#define RMW_A(op) {uint8 x=HU_A; op; HU_A=x; break; } /* Meh... */
-#define RMW_AB(op) {unsigned int EA; uint8 x; GetAB(EA); x=RdMem(EA); op; WrMem(EA,x); break; }
-#define RMW_ABI(reg,op) {unsigned int EA; uint8 x; GetABI(EA,reg); x=RdMem(EA); op; WrMem(EA,x); break; }
+#define RMW_A(op) {uint8 x=HU_A; op; HU_A=x; OP_END; } /* Meh... */
+#define RMW_AB(op) {unsigned int EA; uint8 x; GetAB(EA); x=RdMem(EA); op; WrMem(EA,x); OP_END; }
+#define RMW_ABI(reg,op) {unsigned int EA; uint8 x; GetABI(EA,reg); x=RdMem(EA); op; WrMem(EA,x); OP_END; }
 #define RMW_ABX(op)	RMW_ABI(HU_X,op)
 #define RMW_ABY(op)	RMW_ABI(HU_Y,op)
-#define RMW_IND(op) { unsigned int EA; uint8 x; GetIND(EA); x = RdMem(EA); op; WrMem(EA, x); break; }
-#define RMW_IX(op)  { unsigned int EA; uint8 x; GetIX(EA); x=RdMem(EA); op; WrMem(EA,x); break; }
-#define RMW_IY(op)  { unsigned int EA; uint8 x; GetIY(EA); x=RdMem(EA); op; WrMem(EA,x); break; }
-#define RMW_ZP(op)  { uint8 EA; uint8 x; GetZP(EA); x=HU_Page1[EA]; op; HU_Page1[EA] = x; break; }
-#define RMW_ZPX(op) { uint8 EA; uint8 x; GetZPI(EA,HU_X); x=HU_Page1[EA]; op; HU_Page1[EA] = x; break;}
-
-#define LD_IM(op)	{ uint8 x; x=RdAtPC(); IncPC(); op; break; }
-#define LD_ZP(op)	{ uint8 EA; uint8 x; GetZP(EA); x=HU_Page1[EA]; op; break; }
-#define LD_ZPX(op) 	{ uint8 EA; uint8 x; GetZPI(EA,HU_X); x=HU_Page1[EA]; op; break; }
-#define LD_ZPY(op)  	{ uint8 EA; uint8 x; GetZPI(EA,HU_Y); x=HU_Page1[EA]; op; break; }
-#define LD_AB(op)	{ unsigned int EA; uint8 x; GetAB(EA); x=RdMem(EA); op; break; }
-#define LD_ABI(reg,op)  { unsigned int EA; uint8 x; GetABI(EA,reg); x=RdMem(EA); op; break; }
+#define RMW_IND(op) { unsigned int EA; uint8 x; GetIND(EA); x = RdMem(EA); op; WrMem(EA, x); OP_END; }
+#define RMW_IX(op)  { unsigned int EA; uint8 x; GetIX(EA); x=RdMem(EA); op; WrMem(EA,x); OP_END; }
+#define RMW_IY(op)  { unsigned int EA; uint8 x; GetIY(EA); x=RdMem(EA); op; WrMem(EA,x); OP_END; }
+#define RMW_ZP(op)  { uint8 EA; uint8 x; GetZP(EA); x=HU_Page1[EA]; op; HU_Page1[EA] = x; OP_END; }
+#define RMW_ZPX(op) { uint8 EA; uint8 x; GetZPI(EA,HU_X); x=HU_Page1[EA]; op; HU_Page1[EA] = x; OP_END;}
+
+#define LD_IM(op)	{ uint8 x; x=RdAtPC(); IncPC(); op; OP_END; }
+#define LD_ZP(op)	{ uint8 EA; uint8 x; GetZP(EA); x=HU_Page1[EA]; op; OP_END; }
+#define LD_ZPX(op) 	{ uint8 EA; uint8 x; GetZPI(EA,HU_X); x=HU_Page1[EA]; op; OP_END; }
+#define LD_ZPY(op)  	{ uint8 EA; uint8 x; GetZPI(EA,HU_Y); x=HU_Page1[EA]; op; OP_END; }
+#define LD_AB(op)	{ unsigned int EA; uint8 x; GetAB(EA); x=RdMem(EA); op; OP_END; }
+#define LD_ABI(reg,op)  { unsigned int EA; uint8 x; GetABI(EA,reg); x=RdMem(EA); op; OP_END; }
 #define LD_ABX(op)	LD_ABI(HU_X,op)
 #define LD_ABY(op)	LD_ABI(HU_Y,op)
 
-#define LD_IND(op)	{ unsigned int EA; uint8 x; GetIND(EA); x=RdMem(EA); op; break; }
-#define LD_IX(op)	{ unsigned int EA; uint8 x; GetIX(EA); x=RdMem(EA); op; break; }
-#define LD_IY(op)	{ unsigned int EA; uint8 x; GetIY(EA); x=RdMem(EA); op; break; }
+#define LD_IND(op)	{ unsigned int EA; uint8 x; GetIND(EA); x=RdMem(EA); op; OP_END; }
+#define LD_IX(op)	{ unsigned int EA; uint8 x; GetIX(EA); x=RdMem(EA); op; OP_END; }
+#define LD_IY(op)	{ unsigned int EA; uint8 x; GetIY(EA); x=RdMem(EA); op; OP_END; }
+
+// Block transfer fast path, run at the top of each BMT_* iteration. While the
+// source page is plain memory and the destination is plain RAM or the VDC
+// ports it moves bytes straight through FastMap, in the same order as the
+// per-byte loop. It stops short of a page boundary, the final byte, and the
+// byte that would reach next_user_event, so the loop below still handles
+// those and the cycle counts and exit points are unchanged.
+template<int src_step, int dest_step, bool src_alt, bool dest_alt>
+static INLINE void BlockMoveBurst(const int32 next_user_event)
+{
+ const int32 budget = next_user_event - HuCPU.timestamp;
+
+ if(budget <= 6)
+  return;
+
+ const unsigned int src = HuCPU.bmt_src;
+ const unsigned int dest = HuCPU.bmt_dest;
+ const uint8 src_bank = HuCPU.MPR[src >> 13];
+ const uint8 dest_bank = HuCPU.MPR[dest >> 13];
+ const uint8 dest_flags = HuCPU.BlockMoveFlags[dest_bank];
+
+ if(!(HuCPU.BlockMoveFlags[src_bank] & BMF_DIRECT_READ) || !(dest_flags & (BMF_DIRECT_WRITE | BMF_VDC_PORT)))
+  return;
+
+ const unsigned int src_offs = src & 0x1FFF;
+ const unsigned int dest_offs = dest & 0x1FFF;
+ const bool to_vdc = !(dest_flags & BMF_DIRECT_WRITE);
+ const unsigned int dest_end = to_vdc ? 0x400 : 0x2000;
+ uint32 count = (HuCPU.bmt_length ? HuCPU.bmt_length : 0x10000) - 1;
+
+ if(src_alt && src_offs == 0x1FFF)
+  return;
+
+ if(dest_offs + dest_alt >= dest_end)
+  return;
+
+ if(src_step > 0)
+  count = std::min<uint32>(count, 0x2000 - src_offs);
+ else if(src_step < 0)
+  count = std::min<uint32>(count, src_offs + 1);
+
+ if(dest_step > 0)
+  count = std::min<uint32>(count, dest_end - dest_offs);
+ else if(dest_step < 0)
+  count = std::min<uint32>(count, dest_offs + 1);
+
+ // VDC writes steal a cycle on top of the 6 per byte
+ count = std::min<uint32>(count, (budget - 1) / (to_vdc ? 7 : 6));
+
+ if(!count)
+  return;
+
+ const uint8* sp = HuCPU.FastMap[src_bank] + src_offs;
+ uint32 alt = HuCPU.bmt_alternate;
+
+ if(to_vdc)
+ {
+  unsigned int da = dest_offs;
+
+  for(uint32 i = 0; i < count; i++)
+  {
+   ADDCYC(6);
+   const uint8 v = src_alt ? sp[alt] : *sp;
+   HuC6280_StealCycle();
+   VDC_Write(da + (dest_alt ? alt : 0), v);
+   if(src_alt || dest_alt)
+    alt ^= 1;
+   sp += src_step;
+   da += dest_step;
+  }
+ }
+ else
+ {
+  uint8* dp = HuCPU.FastMap[dest_bank] + dest_offs;
+
+  for(uint32 i = 0; i < count; i++)
+  {
+   const uint8 v = src_alt ? sp[alt] : *sp;
+   if(dest_alt)
+    dp[alt] = v;
+   else
+    *dp = v;
+   if(src_alt || dest_alt)
+    alt ^= 1;
+   sp += src_step;
+   dp += dest_step;
+  }
+  ADDCYC(count * 6);
+ }
+
+ HuCPU.bmt_src += count * src_step;
+ HuCPU.bmt_dest += count * dest_step;
+ HuCPU.bmt_length -= count;
+ HuCPU.bmt_alternate = alt;
+}
 
 #define BMT_PREHONK(pork) HuCPU.in_block_move = IBM_##pork;
 #define BMT_HONKHONK(pork) if(HuCPU.timestamp >= next_user_event) goto GetOutBMT; continue_the_##pork:
 
-#define BMT_TDD	BMT_PREHONK(TDD); do { ADDCYC(6); WrMem(HuCPU.bmt_dest, RdMem(HuCPU.bmt_src)); HuCPU.bmt_src--; HuCPU.bmt_dest--; BMT_HONKHONK(TDD); HuCPU.bmt_length--; } while(HuCPU.bmt_length);
-#define BMT_TAI BMT_PREHONK(TAI); {HuCPU.bmt_alternate = 0; do { ADDCYC(6); WrMem(HuCPU.bmt_dest, RdMem(HuCPU.bmt_src + HuCPU.bmt_alternate)); HuCPU.bmt_dest++; HuCPU.bmt_alternate ^= 1; BMT_HONKHONK(TAI); HuCPU.bmt_length--; } while(HuCPU.bmt_length); }
-#define BMT_TIA BMT_PREHONK(TIA); {HuCPU.bmt_alternate = 0; do { ADDCYC(6); WrMem(HuCPU.bmt_dest + HuCPU.bmt_alternate, RdMem(HuCPU.bmt_src)); HuCPU.bmt_src++; HuCPU.bmt_alternate ^= 1; BMT_HONKHONK(TIA); HuCPU.bmt_length--; } while(HuCPU.bmt_length); } 
-#define BMT_TII BMT_PREHONK(TII); do { ADDCYC(6); WrMem(HuCPU.bmt_dest, RdMem(HuCPU.bmt_src)); HuCPU.bmt_src++; HuCPU.bmt_dest++; BMT_HONKHONK(TII); HuCPU.bmt_length--; } while(HuCPU.bmt_length); 
-#define BMT_TIN BMT_PREHONK(TIN); do { ADDCYC(6); WrMem(HuCPU.bmt_dest, RdMem(HuCPU.bmt_src)); HuCPU.bmt_src++; BMT_HONKHONK(TIN); HuCPU.bmt_length--; } while(HuCPU.bmt_length);
+#define BMT_TDD	BMT_PREHONK(TDD); do { BlockMoveBurst<-1, -1, false, false>(next_user_event); ADDCYC(6); WrMem(HuCPU.bmt_dest, RdMem(HuCPU.bmt_src)); HuCPU.bmt_src--; HuCPU.bmt_dest--; BMT_HONKHONK(TDD); HuCPU.bmt_length--; } while(HuCPU.bmt_length);
+#define BMT_TAI BMT_PREHONK(TAI); {HuCPU.bmt_alternate = 0; do { BlockMoveBurst<0, 1, true, false>(next_user_event); ADDCYC(6); WrMem(HuCPU.bmt_dest, RdMem(HuCPU.bmt_src + HuCPU.bmt_alternate)); HuCPU.bmt_dest++; HuCPU.bmt_alternate ^= 1; BMT_HONKHONK(TAI); HuCPU.bmt_length--; } while(HuCPU.bmt_length); }
+#define BMT_TIA BMT_PREHONK(TIA); {HuCPU.bmt_alternate = 0; do { BlockMoveBurst<1, 0, false, true>(next_user_event); ADDCYC(6); WrMem(HuCPU.bmt_dest + HuCPU.bmt_alternate, RdMem(HuCPU.bmt_src)); HuCPU.bmt_src++; HuCPU.bmt_alternate ^= 1; BMT_HONKHONK(TIA); HuCPU.bmt_length--; } while(HuCPU.bmt_length); } 
+#define BMT_TII BMT_PREHONK(TII); do { BlockMoveBurst<1, 1, false, false>(next_user_event); ADDCYC(6); WrMem(HuCPU.bmt_dest, RdMem(HuCPU.bmt_src)); HuCPU.bmt_src++; HuCPU.bmt_dest++; BMT_HONKHONK(TII); HuCPU.bmt_length--; } while(HuCPU.bmt_length); 
+#define BMT_TIN BMT_PREHONK(TIN); do { BlockMoveBurst<1, 0, false, false>(next_user_event); ADDCYC(6); WrMem(HuCPU.bmt_dest, RdMem(HuCPU.bmt_src)); HuCPU.bmt_src++; BMT_HONKHONK(TIN); HuCPU.bmt_length--; } while(HuCPU.bmt_length);
 
 // Block memory transfer load
-#define LD_BMT(op)	{ PUSH(HU_Y); PUSH(HU_A); PUSH(HU_X); GetAB(HuCPU.bmt_src); GetAB(HuCPU.bmt_dest); GetAB(HuCPU.bmt_length); op; HuCPU.in_block_move = 0; HU_X = POP(); HU_A = POP(); HU_Y = POP(); break; }
+#define LD_BMT(op)	{ PUSH(HU_Y); PUSH(HU_A); PUSH(HU_X); GetAB(HuCPU.bmt_src); GetAB(HuCPU.bmt_dest); GetAB(HuCPU.bmt_length); op; HuCPU.in_block_move = 0; HU_X = POP(); HU_A = POP(); HU_Y = POP(); OP_END; }
 
-#define ST_ZP(r)	{uint8 EA; GetZP(EA); HU_Page1[EA] = r; break;}
-#define ST_ZPX(r)	{uint8 EA; GetZPI(EA,HU_X); HU_Page1[EA] = r; break;}
-#define ST_ZPY(r)	{uint8 EA; GetZPI(EA,HU_Y); HU_Page1[EA] = r; break;}
-#define ST_AB(r)	{unsigned int EA; GetAB(EA); WrMem(EA, r); break;}
-#define ST_ABI(reg,r)	{unsigned int EA; GetABI(EA,reg); WrMem(EA,r); break; }
+#define ST_ZP(r)	{uint8 EA; GetZP(EA); HU_Page1[EA] = r; OP_END;}
+#define ST_ZPX(r)	{uint8 EA; GetZPI(EA,HU_X); HU_Page1[EA] = r; OP_END;}
+#define ST_ZPY(r)	{uint8 EA; GetZPI(EA,HU_Y); HU_Page1[EA] = r; OP_END;}
+#define ST_AB(r)	{unsigned int EA; GetAB(EA); WrMem(EA, r); OP_END;}
+#define ST_ABI(reg,r)	{unsigned int EA; GetABI(EA,reg); WrMem(EA,r); OP_END; }
 #define ST_ABX(r)	ST_ABI(HU_X,r)
 #define ST_ABY(r)	ST_ABI(HU_Y,r)
 
-#define ST_IND(r)	{unsigned int EA; GetIND(EA); WrMem(EA,r); break; }
-#define ST_IX(r)	{unsigned int EA; GetIX(EA); WrMem(EA,r); break; }
-#define ST_IY(r)	{unsigned int EA; GetIY(EA); WrMem(EA,r); break; }
+#define ST_IND(r)	{unsigned int EA; GetIND(EA); WrMem(EA,r); OP_END; }
+#define ST_IX(r)	{unsigned int EA; GetIX(EA); WrMem(EA,r); OP_END; }
+#define ST_IY(r)	{unsigned int EA; GetIY(EA); WrMem(EA,r); OP_END; }
 
 static const uint8 CycTable[256] =
 {                             
@@ -605,8 +700,69 @@ void HuC6280_Power(void)
  HuC6280_Reset();
 }
 
+//threaded dispatch: each opcode ends by fetching the next one and jumping
+//straight to its label through opTable, instead of going back to a single
+//switch. Pending IRQs and the end of the timeslice drop back into the loop
+//so both are handled exactly as before. It's used by default on ARM where
+//the single indirect branch of the switch predicts poorly, define
+//HUC6280_THREADED_DISPATCH or HUC6280_SWITCH_DISPATCH to choose one elsewhere.
+#if defined(__GNUC__) && (defined(__arm__) || defined(__aarch64__)) && !defined(HUC6280_SWITCH_DISPATCH)
+#define HUC6280_THREADED_DISPATCH
+#endif
+
+#ifdef HUC6280_EXTRA_CRAZY
+#define HUC6280_END_OP_FIXPC()
+#else
+#define HUC6280_END_OP_FIXPC() FixPC_PC()
+#endif
+
+#ifdef HUC6280_COUNT_INSTRUCTIONS
+#define HUC6280_COUNT_INSN() HuCPU.instructions++
+#else
+#define HUC6280_COUNT_INSN()
+#endif
+
+#define HUC6280_FETCH()	\
+{	\
+ HUC6280_COUNT_INSN();	\
+ HU_PI = HU_P;	\
+ HuCPU.IRQMaskDelay = HuCPU.IRQMask;	\
+ b1 = RdAtPC();	\
+ ADDCYC(CycTable[b1]);	\
+ IncPC();	\
+}
+
+#ifdef HUC6280_THREADED_DISPATCH
+#define OP(n) op_##n
+#define OP_END	\
+{	\
+ HUC6280_END_OP_FIXPC();	\
+ if(HuCPU.timestamp >= next_event || (HU_IRQlow && !(HU_PI & I_FLAG))) continue;	\
+ HUC6280_FETCH();	\
+ goto *opTable[b1];	\
+}
+#define OP_ROW(h) \
+ &&op_0x##h##0, &&op_0x##h##1, &&op_0x##h##2, &&op_0x##h##3, \
+ &&op_0x##h##4, &&op_0x##h##5, &&op_0x##h##6, &&op_0x##h##7, \
+ &&op_0x##h##8, &&op_0x##h##9, &&op_0x##h##A, &&op_0x##h##B, \
+ &&op_0x##h##C, &&op_0x##h##D, &&op_0x##h##E, &&op_0x##h##F
+#else
+#define OP(n) case n
+#define OP_END break
+#endif
+
 void HuC6280_Run(int32 cycles)
 {
+#ifdef HUC6280_THREADED_DISPATCH
+	static const void *const opTable[256] =
+	{
+	 OP_ROW(0), OP_ROW(1), OP_ROW(2), OP_ROW(3),
+	 OP_ROW(4), OP_ROW(5), OP_ROW(6), OP_ROW(7),
+	 OP_ROW(8), OP_ROW(9), OP_ROW(A), OP_ROW(B),
+	 OP_ROW(C), OP_ROW(D), OP_ROW(E), OP_ROW(F)
+	};
+#endif
+
 	const int32 next_user_event = HuCPU.previous_next_user_event + cycles * pce_overclocked;
 
 	HuCPU.previous_next_user_event = next_user_event;
@@ -682,22 +838,20 @@ void HuC6280_Run(int32 cycles)
 	  }	// end if(HU_IRQlow)
 
 	  //printf("%04x\n", GetRealPC());
-	  HU_PI = HU_P;
-	  HuCPU.IRQMaskDelay = HuCPU.IRQMask;
-
-	  b1 = RdAtPC();
-
-	  ADDCYC(CycTable[b1]);
-
-	  IncPC();
+	  HUC6280_FETCH();
 
+	  #ifdef HUC6280_THREADED_DISPATCH
+	  goto *opTable[b1];
+	  {
+	   #include "huc6280_ops.inc"
+	  }
+	  #else
           switch(b1)
           {
            #include "huc6280_ops.inc"
           } 
 
-	  #ifndef HUC6280_EXTRA_CRAZY
- 	  FixPC_PC();
+ 	  HUC6280_END_OP_FIXPC();
 	  #endif
 	 }	// end while(HuCPU.timestamp < next_event)
 
@@ -47,6 +47,10 @@ struct HuC6280
 
 	int32 previous_next_user_event;
 
+	#ifdef HUC6280_COUNT_INSTRUCTIONS
+	uint64 instructions;	// executed opcodes, for measuring instructions per second
+	#endif
+
 	//
 	//
 	//
@@ -54,6 +58,13 @@ struct HuC6280
 
 	readfunc PCERead[0x100];
 	writefunc PCEWrite[0x100];
+
+	// Per-bank hints for the block transfer fast path, kept in sync with
+	// PCERead/PCEWrite by whoever maps the bank
+	uint8 BlockMoveFlags[0x100];
+	#define BMF_DIRECT_READ		1	// reads are FastMap[bank][A & 0x1FFF] with no side effects
+	#define BMF_DIRECT_WRITE	2	// writes go straight to FastMap[bank][A & 0x1FFF]
+	#define BMF_VDC_PORT		4	// $0000-$03FF is VDC_Write() with a stolen cycle
 };
 
 void HuC6280_Run(int32 cycles);
@@ -251,6 +251,7 @@ static MDFN_COLD void Load(MDFNFILE *fp)
   {
    HuCPU.PCERead[x] = PCEBusRead;
    HuCPU.PCEWrite[x] = PCENullWrite;
+   HuCPU.BlockMoveFlags[x] = 0;
   }
 
   if(IsHES)
@@ -304,6 +305,7 @@ static void LoadCommonPre(void)
  {
   HuCPU.PCERead[x] = PCEBusRead;
   HuCPU.PCEWrite[x] = PCENullWrite;
+  HuCPU.BlockMoveFlags[x] = 0;
  }
 
  MDFNMP_Init(1024, (1 << 21) / 1024);
@@ -329,7 +331,10 @@ static void LoadCommon(void)
   HuCPU.PCEWrite[0xF8] = HuCPU.PCEWrite[0xF9] = HuCPU.PCEWrite[0xFA] = HuCPU.PCEWrite[0xFB] = BaseRAMWriteSGX;
 
   for(int x = 0xf8; x < 0xfb; x++)
+  {
    HuCPU.FastMap[x] = &BaseRAM[(x & 0x3) * 8192];
+   HuCPU.BlockMoveFlags[x] = BMF_DIRECT_READ | BMF_DIRECT_WRITE;
+  }
 
   HuCPU.PCERead[0xFF] = IOReadSGX;
  }
@@ -342,7 +347,10 @@ static void LoadCommon(void)
   HuCPU.PCEWrite[0xF9] = HuCPU.PCEWrite[0xFA] = HuCPU.PCEWrite[0xFB] = BaseRAMWrite_Mirrored;
 
   for(int x = 0xf8; x < 0xfb; x++)
+  {
    HuCPU.FastMap[x] = &BaseRAM[0];
+   HuCPU.BlockMoveFlags[x] = BMF_DIRECT_READ | BMF_DIRECT_WRITE;
+  }
 
   HuCPU.PCERead[0xFF] = IORead;
  }
@@ -350,6 +358,7 @@ static void LoadCommon(void)
  MDFNMP_AddRAM(IsSGX ? 32768 : 8192, 0xf8 * 8192, BaseRAM);
 
  HuCPU.PCEWrite[0xFF] = IOWrite;
+ HuCPU.BlockMoveFlags[0xFF] = BMF_VDC_PORT;
 
  psg = new PCEFast_PSG(sbuf);
 
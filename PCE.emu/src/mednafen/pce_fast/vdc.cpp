@@ -25,6 +25,16 @@
 #include <mednafen/cputest/cputest.h>
 #include <trio/trio.h>
 #include <math.h>
+#ifdef PCE_FAST_VDC_CHECK_SIMD
+#include <zlib.h>
+#endif
+
+// Vectorised BG/SPR priority merge, x86 keeps its cmov path
+#if !defined(ARCH_X86) && defined(__GNUC__)
+#define VDC_SIMD_MIX
+typedef uint16 v8u16 __attribute__((vector_size(16)));
+typedef int16 v8i16 __attribute__((vector_size(16)));
+#endif
 
 namespace PCE_Fast
 {
@@ -54,6 +64,39 @@ vce_t vce;
 int VDC_TotalChips;
 vdc_t vdc_chips[2];
 
+#ifdef PCE_FAST_VDC_CHECK_SIMD
+// Running CRCs of the SIMD and scalar reference output, compared every frame
+static uint32 simd_check_crc, scalar_check_crc;
+static uint32 simd_check_tile_errors;
+#endif
+
+// Spreads the 8 bits of a bitplane row into the low bit of 8 bytes, bit n goes to byte n
+static INLINE uint64 SpreadPlaneBits(uint32 bits)
+{
+ uint64 x = bits & 0xFF;
+
+ x = (x | (x << 28)) & 0x0000000F0000000FULL;
+ x = (x | (x << 14)) & 0x0003000300030003ULL;
+ x = (x | (x <<  7)) & 0x0101010101010101ULL;
+
+ return x;
+}
+
+// Planar to chunky conversion of 8 pixels, pixel n of the planes ends up in byte n
+static INLINE uint64 PlanarToChunky(uint32 plane0, uint32 plane1, uint32 plane2, uint32 plane3)
+{
+ return SpreadPlaneBits(plane0) | (SpreadPlaneBits(plane1) << 1) | (SpreadPlaneBits(plane2) << 2) | (SpreadPlaneBits(plane3) << 3);
+}
+
+// Stores chunky pixels with pixel 0 at the lowest address
+static INLINE void StoreChunkyPixels(uint8 *target, uint64 pixels)
+{
+ #ifdef MSB_FIRST
+ pixels = MDFN_bswap64(pixels);
+ #endif
+ memcpy(target, &pixels, sizeof(pixels));
+}
+
 static INLINE void FixPCache(int entry)
 {
  const uint32* __restrict__ cm32 = systemColorMap32[vce.CR >> 7];
@@ -85,7 +128,17 @@ static INLINE void FixTileCache(vdc_t *which_vdc, uint16 A)
  uint32 bitplane01 = which_vdc->VRAM[y + charname * 16];
  uint32 bitplane23 = which_vdc->VRAM[y+ 8 + charname * 16];
 
- *tc = 0;
+ // The BG line renderer stores the cache as a native uint64, pixel 0 in the top byte on little endian
+ uint64 pixels = PlanarToChunky(bitplane01, bitplane01 >> 8, bitplane23, bitplane23 >> 8);
+
+ #ifdef MSB_FIRST
+ *tc = pixels;
+ #else
+ *tc = MDFN_bswap64(pixels);
+ #endif
+
+ #ifdef PCE_FAST_VDC_CHECK_SIMD
+ uint64 ref = 0;
 
  for(int x = 0; x < 8; x++)
  {
@@ -95,11 +148,15 @@ static INLINE void FixTileCache(vdc_t *which_vdc, uint16 A)
   raw_pixel |= ((bitplane23 >> (x + 8)) & 1) << 3;
 
   #ifdef MSB_FIRST
-  *tc |= (uint64)raw_pixel << ((x) * 8);
+  ref |= (uint64)raw_pixel << ((x) * 8);
   #else
-  *tc |= (uint64)raw_pixel << ((7 - x) * 8);
+  ref |= (uint64)raw_pixel << ((7 - x) * 8);
   #endif
  }
+
+ if(ref != *tc)
+  simd_check_tile_errors++;
+ #endif
 }
 
 static INLINE void CheckFixSpriteTileCache(vdc_t *which_vdc, uint16 no, uint32 special)
@@ -127,13 +184,19 @@ static INLINE void CheckFixSpriteTileCache(vdc_t *which_vdc, uint16 no, uint32 s
    uint32 bitplane0 = which_vdc->VRAM[y + 0x00 + no * 0x40 + ((special & 1) << 5)];
    uint32 bitplane1 = which_vdc->VRAM[y + 0x10 + no * 0x40 + ((special & 1) << 5)];
 
+   StoreChunkyPixels(tc, PlanarToChunky(bitplane0, bitplane1, 0, 0));
+   StoreChunkyPixels(tc + 8, PlanarToChunky(bitplane0 >> 8, bitplane1 >> 8, 0, 0));
+
+   #ifdef PCE_FAST_VDC_CHECK_SIMD
    for(int x = 0; x < 16; x++)
    {
     uint32 raw_pixel;
     raw_pixel = ((bitplane0 >> x) & 1) << 0;
     raw_pixel |= ((bitplane1 >> x) & 1) << 1;
-    tc[x] = raw_pixel;
+    if(tc[x] != raw_pixel)
+     simd_check_tile_errors++;
    }
+   #endif
   }
  }
  else
@@ -147,6 +210,10 @@ static INLINE void CheckFixSpriteTileCache(vdc_t *which_vdc, uint16 no, uint32 s
    uint32 bitplane2 = which_vdc->VRAM[y + 0x20 + no * 0x40];
    uint32 bitplane3 = which_vdc->VRAM[y + 0x30 + no * 0x40];
 
+   StoreChunkyPixels(tc, PlanarToChunky(bitplane0, bitplane1, bitplane2, bitplane3));
+   StoreChunkyPixels(tc + 8, PlanarToChunky(bitplane0 >> 8, bitplane1 >> 8, bitplane2 >> 8, bitplane3 >> 8));
+
+   #ifdef PCE_FAST_VDC_CHECK_SIMD
    for(int x = 0; x < 16; x++)
    {
     uint32 raw_pixel;
@@ -154,8 +221,10 @@ static INLINE void CheckFixSpriteTileCache(vdc_t *which_vdc, uint16 no, uint32 s
     raw_pixel |= ((bitplane1 >> x) & 1) << 1;
     raw_pixel |= ((bitplane2 >> x) & 1) << 2;
     raw_pixel |= ((bitplane3 >> x) & 1) << 3;
-    tc[x] = raw_pixel;
+    if(tc[x] != raw_pixel)
+     simd_check_tile_errors++;
    }
+   #endif
   }
  }
 
@@ -1059,7 +1128,26 @@ static void MixBGSPR(const uint32 count, const uint8*  __restrict__ bg_linebuf,
 #else
  uint32 x = 0;
 
- do
+ #ifdef VDC_SIMD_MIX
+ // Pick the sprite pixel when it has priority or the BG pixel is transparent,
+ // 8 pixels at a time, only the palette lookups stay scalar
+ for(; x + 8 <= count; x += 8)
+ {
+  const uint8 *bgp = &bg_linebuf[x];
+  const v8u16 bg = { bgp[0], bgp[1], bgp[2], bgp[3], bgp[4], bgp[5], bgp[6], bgp[7] };
+  v8u16 spr;
+
+  memcpy(&spr, &spr_linebuf[x], sizeof(spr));
+
+  const v8u16 use_spr = (v8u16)(((bg & 0xF) == 0) | ((v8i16)spr < 0));
+  const v8u16 pixel = (bg & ~use_spr) | (spr & use_spr & 0x1FF);
+
+  for(unsigned i = 0; i < 8; i++)
+   target[x + i] = vce.color_table_cache[pixel[i]];
+ }
+ #endif
+
+ for(; x < count; x++)
  {
   uint32 pixel = bg_linebuf[x] | (spr_linebuf[x] << 16);
 
@@ -1067,7 +1155,26 @@ static void MixBGSPR(const uint32 count, const uint8*  __restrict__ bg_linebuf,
    pixel >>= 16;
 
   target[x] = vce.color_table_cache[pixel & 0x1FF];
- } while(MDFN_LIKELY(++x != count));
+ }
+#endif
+
+#ifdef PCE_FAST_VDC_CHECK_SIMD
+ {
+  T ref[1024];
+
+  assert(count <= 1024);
+  for(uint32 x = 0; x < count; x++)
+  {
+   uint32 pixel = bg_linebuf[x] | (spr_linebuf[x] << 16);
+
+   if((int32)(pixel & 0x8000000F) <= 0)
+    pixel >>= 16;
+
+   ref[x] = vce.color_table_cache[pixel & 0x1FF];
+  }
+  simd_check_crc = crc32(simd_check_crc, (const Bytef *)target, count * sizeof(T));
+  scalar_check_crc = crc32(scalar_check_crc, (const Bytef *)ref, count * sizeof(T));
+ }
 #endif
 }
 
@@ -1560,6 +1667,13 @@ void VDC_RunFrame(EmulateSpecStruct *espec, bool IsHES)
    case 32: BigDrawThingy<1, uint32, uint32>(espec, IsHES); break;
   }
  }
+
+ #ifdef PCE_FAST_VDC_CHECK_SIMD
+ if(simd_check_crc != scalar_check_crc || simd_check_tile_errors)
+  printf("VDC SIMD check failed: CRC %08x vs scalar %08x, %u tile cache errors\n", simd_check_crc, scalar_check_crc, simd_check_tile_errors);
+ simd_check_crc = scalar_check_crc = 0;
+ simd_check_tile_errors = 0;
+ #endif
 }
 
 void VDC_Reset(void)
@@ -2,6 +2,7 @@
 #define LOGTAG "main"
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuAppInlines.hh>
+#include <emuframework/BackupMemFlusher.hh>
 #include "internal.hh"
 
 extern "C"
@@ -269,10 +270,20 @@ void EmuSystem::saveBackupMem() // for manually saving when not closing game
 	if(gameIsRunning())
 	{
 		logMsg("saving backup memory");
-		T123Save(BupRam, 0x10000, 1, bupPath.data());
+		if(!backupMemFlusher.flush())
+			T123Save(BupRam, 0x10000, 1, bupPath.data());
 	}
 }
 
+uint EmuSystem::backupMemRegions(BackupMemRegion (&region)[MAX_BACKUP_MEM_REGIONS])
+{
+	if(!gameIsRunning() || !BupRam)
+		return 0;
+	// T123Save() type 1 writes the buffer unmodified
+	region[0] = {BupRam, 0x10000, bupPath};
+	return 1;
+}
+
 static bool yabauseIsInit = 0;
 
 void EmuSystem::closeSystem()
@@ -43,6 +43,8 @@ dsp4.cpp \
 fxemu.cpp \
 fxinst.cpp \
 gfx.cpp \
+gfxrender.cpp \
+gfxthread.cpp \
 globals.cpp \
 loadzip.cpp \
 memmap.cpp \
@@ -67,7 +69,8 @@ apu/apu.cpp \
 apu/bapu/dsp/sdsp.cpp \
 apu/bapu/dsp/SPC_DSP.cpp \
 apu/bapu/smp/smp.cpp \
-apu/bapu/smp/smp_state.cpp
+apu/bapu/smp/smp_state.cpp \
+filter/snes_ntsc.c
 # conffile.cpp crosshairs.cpp logger.cpp screenshot.cpp snes9x.cpp
 
 SRC += \
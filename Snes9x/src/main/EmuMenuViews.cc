@@ -1,8 +1,14 @@
 #include <emuframework/OptionView.hh>
 #include <emuframework/EmuMainMenuView.hh>
+#include <emuframework/InputMovie.hh>
+#include <emuframework/Netplay.hh>
 #include "EmuCheatViews.hh"
 #include "internal.hh"
 #include <snes9x.h>
+#ifndef SNES9X_VERSION_1_4
+#include <gfxthread.h>
+#include <apu/apu.h>
+#endif
 
 #ifndef SNES9X_VERSION_1_4
 static constexpr bool HAS_NSRT = true;
@@ -129,14 +135,91 @@ class CustomVideoOptionView : public VideoOptionView
 		videoSystemItem
 	};
 
+	#ifndef SNES9X_VERSION_1_4
+	BoolMenuItem threadedRendering
+	{
+		"Threaded Rendering",
+		(bool)optionThreadedRendering,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionThreadedRendering = item.flipBoolValue(*this);
+			S9xSetThreadedRendering(optionThreadedRendering);
+		}
+	};
+
+	TextMenuItem renderingBenchmark
+	{
+		"Measure Threaded Rendering",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!EmuSystem::gameIsRunning())
+			{
+				EmuApp::postMessage(true, "Load a SuperFX or SA-1 game first");
+				return;
+			}
+			if(netplay.isActive() || inputMovie.isActive())
+			{
+				EmuApp::postMessage(true, "Stop netplay or the input movie first");
+				return;
+			}
+			if(!startRenderingBenchmark())
+				EmuApp::postMessage(true, "Run the game before measuring");
+		}
+	};
+
+	TextMenuItem ntscFilterItem[5]
+	{
+		{"Off", [](){ optionNtscFilter = 0; setNtscFilter(0); }},
+		{"Composite", [](){ optionNtscFilter = 1; setNtscFilter(1); }},
+		{"S-Video", [](){ optionNtscFilter = 2; setNtscFilter(2); }},
+		{"RGB", [](){ optionNtscFilter = 3; setNtscFilter(3); }},
+		{"Monochrome", [](){ optionNtscFilter = 4; setNtscFilter(4); }},
+	};
+
+	MultiChoiceMenuItem ntscFilter
+	{
+		"NTSC Filter",
+		optionNtscFilter,
+		ntscFilterItem
+	};
+	#endif
+
 public:
 	CustomVideoOptionView(ViewAttachParams attach): VideoOptionView{attach, true}
 	{
 		loadStockItems();
 		item.emplace_back(&systemSpecificHeading);
 		item.emplace_back(&videoSystem);
+		#ifndef SNES9X_VERSION_1_4
+		item.emplace_back(&threadedRendering);
+		item.emplace_back(&renderingBenchmark);
+		item.emplace_back(&ntscFilter);
+		#endif
+	}
+};
+
+#ifndef SNES9X_VERSION_1_4
+class CustomAudioOptionView : public AudioOptionView
+{
+	BoolMenuItem threadedAPU
+	{
+		"Threaded APU",
+		(bool)optionThreadedAPU,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionThreadedAPU = item.flipBoolValue(*this);
+			S9xSetThreadedAPU(optionThreadedAPU);
+		}
+	};
+
+public:
+	CustomAudioOptionView(ViewAttachParams attach): AudioOptionView{attach, true}
+	{
+		loadStockItems();
+		item.emplace_back(&threadedAPU);
 	}
 };
+#endif
 
 class CustomSystemOptionView : public SystemOptionView
 {
@@ -168,6 +251,9 @@ View *EmuApp::makeCustomView(ViewAttachParams attach, ViewID id)
 	switch(id)
 	{
 		case ViewID::VIDEO_OPTIONS: return new CustomVideoOptionView(attach);
+		#ifndef SNES9X_VERSION_1_4
+		case ViewID::AUDIO_OPTIONS: return new CustomAudioOptionView(attach);
+		#endif
 		case ViewID::INPUT_OPTIONS: return new CustomInputOptionView(attach);
 		case ViewID::SYSTEM_OPTIONS: return new CustomSystemOptionView(attach);
 		case ViewID::EDIT_CHEATS: return new EmuEditCheatListView(attach);
@@ -1,6 +1,9 @@
 #define LOGTAG "main"
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuAppInlines.hh>
+#include <emuframework/EmuOptions.hh>
+#include <emuframework/VideoFilterThreads.hh>
+#include <imagine/base/Timer.hh>
 #include "internal.hh"
 
 #include <snes9x.h>
@@ -11,6 +14,8 @@
 #ifndef SNES9X_VERSION_1_4
 #include <apu/apu.h>
 #include <controls.h>
+#include <gfxthread.h>
+#include <filter/snes_ntsc.h>
 #else
 #include <apu.h>
 #include <soundux.h>
@@ -21,9 +26,16 @@ static constexpr auto pixFmt = IG::PIXEL_FMT_RGB565;
 static EmuVideo *emuVideo{};
 static const uint heightChangeFrameDelay = 4;
 static uint heightChangeFrames = heightChangeFrameDelay;
+#ifndef SNES9X_VERSION_1_4
+static snes_ntsc_t *snesNtsc{};
+static int ntscBurstPhase = 0;
+#endif
 bool EmuSystem::hasCheats = true;
 bool EmuSystem::hasPALVideoSystem = true;
 bool EmuSystem::hasResetModes = true;
+#ifndef SNES9X_VERSION_1_4
+bool EmuSystem::hasVideoFilters = true;
+#endif
 #ifdef SNES9X_VERSION_1_4
 static uint audioFramesPerUpdate = 0;
 #endif
@@ -60,6 +72,55 @@ const char *EmuSystem::systemName()
 }
 
 #ifndef SNES9X_VERSION_1_4
+void setNtscFilter(uint preset)
+{
+	static snes_ntsc_setup_t const *const setup[] {&snes_ntsc_composite, &snes_ntsc_svideo, &snes_ntsc_rgb, &snes_ntsc_monochrome};
+	if(!preset || preset > IG::size(setup))
+	{
+		free(snesNtsc);
+		snesNtsc = {};
+		return;
+	}
+	if(!snesNtsc)
+	{
+		snesNtsc = (snes_ntsc_t*)malloc(sizeof(snes_ntsc_t));
+		if(!snesNtsc)
+			return;
+	}
+	snes_ntsc_init(snesNtsc, setup[preset - 1]);
+}
+
+static void writeNtscFrame(IG::Pixmap srcPix)
+{
+	// hi-res lines filter down to the same output width as low-res ones
+	bool hires = srcPix.w() > SNES_WIDTH;
+	int inWidth = hires ? srcPix.w() / 2 : srcPix.w();
+	emuVideo->setFormat({{SNES_NTSC_OUT_WIDTH(inWidth), srcPix.h()}, pixFmt});
+	auto img = emuVideo->startFrame();
+	struct
+	{
+		IG::Pixmap src, dest;
+		int burstPhase;
+		bool hires;
+	} frame{srcPix, img.pixmap(), ntscBurstPhase, hires};
+	ntscBurstPhase = (ntscBurstPhase + 1) % snes_ntsc_burst_count;
+	// the burst phase advances every line, so each band starts from its own row's phase
+	videoFilterThreads.run(std::min(frame.src.h(), frame.dest.h()), optionVideoFilterThreads,
+		[&frame](uint startRow, uint endRow)
+		{
+			auto src = (const uint16*)frame.src.pixel({0, (int)startRow});
+			auto out = frame.dest.pixel({0, (int)startRow});
+			int burstPhase = (frame.burstPhase + startRow) % snes_ntsc_burst_count;
+			if(frame.hires)
+				snes_ntsc_blit_hires(snesNtsc, src, frame.src.pitchPixels(), burstPhase,
+					frame.src.w(), endRow - startRow, out, frame.dest.pitchBytes());
+			else
+				snes_ntsc_blit(snesNtsc, src, frame.src.pitchPixels(), burstPhase,
+					frame.src.w(), endRow - startRow, out, frame.dest.pitchBytes());
+		});
+	img.endFrame();
+}
+
 bool8 S9xDeinitUpdate (int width, int height)
 #else
 bool8 S9xDeinitUpdate(int width, int height, bool8)
@@ -78,6 +139,13 @@ bool8 S9xDeinitUpdate(int width, int height, bool8)
 		heightChangeFrames = heightChangeFrameDelay;
 	}
 	IG::Pixmap srcPix = {{{width, height}, pixFmt}, GFX.Screen};
+	#ifndef SNES9X_VERSION_1_4
+	if(snesNtsc)
+	{
+		writeNtscFrame(srcPix);
+		return 1;
+	}
+	#endif
 	emuVideo->setFormat(srcPix);
 	emuVideo->writeFrame(srcPix);
 	return 1;
@@ -138,6 +206,149 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 		return EmuSystem::makeFileReadError();
 }
 
+#ifndef SNES9X_VERSION_1_4
+// the held buttons aren't part of the freeze data, store them after it
+static const uint stateMemPadBytes = sizeof(uint16) * EmuSystem::maxPlayers;
+
+size_t EmuSystem::stateMemSize()
+{
+	return S9xFreezeSize() + stateMemPadBytes;
+}
+
+bool EmuSystem::saveStateMem(void *buff, size_t size)
+{
+	auto freezeSize = size - stateMemPadBytes;
+	if(!S9xFreezeGameMem((uint8*)buff, freezeSize))
+		return false;
+	auto pad = (uint16*)((char*)buff + freezeSize);
+	iterateTimes((uint)maxPlayers, p)
+	{
+		memcpy(&pad[p], S9xGetJoypadBits(p), sizeof(uint16));
+	}
+	return true;
+}
+
+bool EmuSystem::loadStateMem(const void *buff, size_t size)
+{
+	auto freezeSize = size - stateMemPadBytes;
+	if(S9xUnfreezeGameMem((const uint8*)buff, freezeSize) != SUCCESS)
+		return false;
+	auto pad = (const uint16*)((const char*)buff + freezeSize);
+	iterateTimes((uint)maxPlayers, p)
+	{
+		memcpy(S9xGetJoypadBits(p), &pad[p], sizeof(uint16));
+	}
+	IPPU.RenderThisFrame = TRUE;
+	return true;
+}
+#endif
+
+#ifndef SNES9X_VERSION_1_4
+static constexpr uint renderBenchmarkFrames = 600;
+static constexpr uint renderBenchmarkSliceMSecs = 50;
+static Base::Timer renderBenchmarkTimer{};
+static std::unique_ptr<char[]> renderBenchmarkState{};
+static size_t renderBenchmarkStateSize = 0;
+static uint renderBenchmarkPass = 0, renderBenchmarkFrame = 0;
+static IG::Time renderBenchmarkTime[2]{};
+
+static void endRenderingBenchmark()
+{
+	renderBenchmarkTimer.deinit();
+	S9xSetThreadedRendering(optionThreadedRendering);
+	// leave the game where it was before measuring
+	EmuSystem::loadStateMem(renderBenchmarkState.get(), renderBenchmarkStateSize);
+	renderBenchmarkState.reset();
+}
+
+static void runRenderingBenchmarkSlice()
+{
+	if(!EmuSystem::gameIsRunning())
+	{
+		cancelRenderingBenchmark();
+		return;
+	}
+	if(EmuSystem::isActive())
+	{
+		// the game was resumed, its frames would mix with the measured ones
+		endRenderingBenchmark();
+		EmuApp::postMessage(true, "Rendering measurement interrupted");
+		return;
+	}
+	auto startTime = IG::Time::now();
+	auto endTime = startTime + IG::Time::makeWithMSecs(renderBenchmarkSliceMSecs);
+	auto now = startTime;
+	while(renderBenchmarkFrame < renderBenchmarkFrames && now < endTime)
+	{
+		EmuSystem::runFrame(emuVideo, false);
+		renderBenchmarkFrame++;
+		now = IG::Time::now();
+	}
+	S9xSyncRenderThread();
+	renderBenchmarkTime[renderBenchmarkPass] += IG::Time::now() - startTime;
+	if(renderBenchmarkFrame < renderBenchmarkFrames)
+		return;
+	if(renderBenchmarkPass == 0)
+	{
+		// run the same frames again with the render thread
+		EmuSystem::loadStateMem(renderBenchmarkState.get(), renderBenchmarkStateSize);
+		S9xSetThreadedRendering(TRUE);
+		renderBenchmarkPass = 1;
+		renderBenchmarkFrame = 0;
+		EmuApp::printfMessage(2, false, "Measuring threaded rendering...");
+		return;
+	}
+	endRenderingBenchmark();
+	double serialFps = renderBenchmarkFrames / (double)renderBenchmarkTime[0];
+	double threadedFps = renderBenchmarkFrames / (double)renderBenchmarkTime[1];
+	const char *chip = Settings.SuperFX ? "SuperFX" : Settings.SA1 ? "SA-1" : "No coprocessor";
+	logMsg("rendering benchmark: %.2f fps serial, %.2f fps threaded (%s)", serialFps, threadedFps, chip);
+	EmuApp::printfMessage(6, false, "%s: %.2f fps serial\n%.2f fps threaded (%+.1f%%)",
+		chip, serialFps, threadedFps, (threadedFps / serialFps - 1.) * 100.);
+}
+
+bool startRenderingBenchmark()
+{
+	if(renderBenchmarkState)
+		return true;
+	if(!emuVideo)
+		return false;
+	renderBenchmarkStateSize = EmuSystem::stateMemSize();
+	renderBenchmarkState = std::make_unique<char[]>(renderBenchmarkStateSize);
+	if(!EmuSystem::saveStateMem(renderBenchmarkState.get(), renderBenchmarkStateSize))
+	{
+		renderBenchmarkState.reset();
+		return false;
+	}
+	renderBenchmarkPass = 0;
+	renderBenchmarkFrame = 0;
+	renderBenchmarkTime[0] = renderBenchmarkTime[1] = {};
+	S9xSetThreadedRendering(FALSE);
+	EmuApp::printfMessage(2, false, "Measuring serial rendering...");
+	renderBenchmarkTimer.callbackAfterMSec(
+		[]()
+		{
+			runRenderingBenchmarkSlice();
+		}, 1, 1, {});
+	return true;
+}
+
+void cancelRenderingBenchmark()
+{
+	renderBenchmarkTimer.deinit();
+	renderBenchmarkState.reset();
+	S9xSetThreadedRendering(optionThreadedRendering);
+}
+#endif
+
+uint EmuSystem::memSearchRegions(MemSearchRegion (&region)[MAX_MEM_SEARCH_REGIONS])
+{
+	if(!gameIsRunning())
+		return 0;
+	region[0] = {Memory.RAM, 0x20000, 0x7E0000, false};
+	return 1;
+}
+
 void EmuSystem::saveBackupMem() // for manually saving when not closing game
 {
 	if(gameIsRunning())
@@ -166,6 +377,11 @@ void S9xAutoSaveSRAM (void)
 void EmuSystem::closeSystem()
 {
 	saveBackupMem();
+	#ifndef SNES9X_VERSION_1_4
+	cancelRenderingBenchmark();
+	S9xDeinitThreadedRendering();
+	S9xDeinitThreadedAPU();
+	#endif
 }
 
 bool EmuSystem::vidSysIsPAL() { return Settings.PAL; }
@@ -286,6 +502,8 @@ void EmuSystem::runFrame(EmuVideo *video, bool renderAudio)
 	// video rendered in S9xDeinitUpdate
 	#ifdef SNES9X_VERSION_1_4
 	mixSamples(audioFramesPerUpdate, renderAudio);
+	#else
+	S9xAPUEndFrame();
 	#endif
 }
 
@@ -173,6 +173,11 @@ void EmuSystem::handleInputAction(uint state, uint emuKey)
 	padData = IG::setOrClearBits(padData, (uint16)(emuKey & 0xFFFF), state == Input::PUSHED);
 }
 
+uint EmuSystem::inputActionForPlayer(uint emuKey, uint player)
+{
+	return (emuKey & ~(0x7u << 29)) | (player << 29);
+}
+
 void EmuSystem::clearInputBuffers(EmuInputView &view)
 {
 	iterateTimes((uint)maxPlayers, p)
@@ -15,6 +15,9 @@ extern Byte1Option optionMultitap;
 extern Byte1Option optionVideoSystem;
 #ifndef SNES9X_VERSION_1_4
 extern Byte1Option optionBlockInvalidVRAMAccess;
+extern Byte1Option optionThreadedRendering;
+extern Byte1Option optionThreadedAPU;
+extern Byte1Option optionNtscFilter;
 #endif
 extern int snesInputPort;
 extern uint doubleClickFrames, rightClickFrames;
@@ -30,6 +33,13 @@ static const int &snesActiveInputPort = snesInputPort;
 #endif
 
 void setupSNESInput();
+#ifndef SNES9X_VERSION_1_4
+void setNtscFilter(uint preset);
+// runs the same frames with threaded rendering off then on, in short slices from a timer,
+// and reports the emulation thread's frame rate for both
+bool startRenderingBenchmark();
+void cancelRenderingBenchmark();
+#endif
 
 #ifndef SNES9X_VERSION_1_4
 uint16 *S9xGetJoypadBits(uint idx);
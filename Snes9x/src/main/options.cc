@@ -1,11 +1,16 @@
 #include <emuframework/EmuApp.hh>
 #include "internal.hh"
 #include <snes9x.h>
+#ifndef SNES9X_VERSION_1_4
+#include <gfxthread.h>
+#include <apu/apu.h>
+#endif
 
 enum
 {
 	CFGKEY_MULTITAP = 276, CFGKEY_BLOCK_INVALID_VRAM_ACCESS = 277,
-	CFGKEY_VIDEO_SYSTEM = 278
+	CFGKEY_VIDEO_SYSTEM = 278, CFGKEY_THREADED_RENDERING = 279,
+	CFGKEY_THREADED_APU = 280, CFGKEY_NTSC_FILTER = 281
 };
 
 #ifdef SNES9X_VERSION_1_4
@@ -18,6 +23,9 @@ Byte1Option optionMultitap{CFGKEY_MULTITAP, 0};
 Byte1Option optionVideoSystem{CFGKEY_VIDEO_SYSTEM, 0, false, optionIsValidWithMax<3>};
 #ifndef SNES9X_VERSION_1_4
 Byte1Option optionBlockInvalidVRAMAccess{CFGKEY_BLOCK_INVALID_VRAM_ACCESS, 1};
+Byte1Option optionThreadedRendering{CFGKEY_THREADED_RENDERING, 0};
+Byte1Option optionThreadedAPU{CFGKEY_THREADED_APU, 0};
+Byte1Option optionNtscFilter{CFGKEY_NTSC_FILTER, 0, false, optionIsValidWithMax<4>};
 #endif
 const AspectRatioInfo EmuSystem::aspectRatioInfo[] =
 {
@@ -38,6 +46,9 @@ EmuSystem::Error EmuSystem::onOptionsLoaded()
 {
 	#ifndef SNES9X_VERSION_1_4
 	Settings.BlockInvalidVRAMAccessMaster = optionBlockInvalidVRAMAccess;
+	S9xSetThreadedRendering(optionThreadedRendering);
+	S9xSetThreadedAPU(optionThreadedAPU);
+	setNtscFilter(optionNtscFilter);
 	#endif
 	return {};
 }
@@ -51,6 +62,9 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 		bcase CFGKEY_VIDEO_SYSTEM: optionVideoSystem.readFromIO(io, readSize);
 		#ifndef SNES9X_VERSION_1_4
 		bcase CFGKEY_BLOCK_INVALID_VRAM_ACCESS: optionBlockInvalidVRAMAccess.readFromIO(io, readSize);
+		bcase CFGKEY_THREADED_RENDERING: optionThreadedRendering.readFromIO(io, readSize);
+		bcase CFGKEY_THREADED_APU: optionThreadedAPU.readFromIO(io, readSize);
+		bcase CFGKEY_NTSC_FILTER: optionNtscFilter.readFromIO(io, readSize);
 		#endif
 	}
 	return 1;
@@ -62,5 +76,8 @@ void EmuSystem::writeConfig(IO &io)
 	optionVideoSystem.writeWithKeyIfNotDefault(io);
 	#ifndef SNES9X_VERSION_1_4
 	optionBlockInvalidVRAMAccess.writeWithKeyIfNotDefault(io);
+	optionThreadedRendering.writeWithKeyIfNotDefault(io);
+	optionThreadedAPU.writeWithKeyIfNotDefault(io);
+	optionNtscFilter.writeWithKeyIfNotDefault(io);
 	#endif
 }
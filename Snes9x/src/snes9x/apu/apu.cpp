@@ -190,6 +190,8 @@
  ***********************************************************************************/
 
 #include <math.h>
+#include <imagine/thread/Thread.hh>
+#include <imagine/thread/Semaphore.hh>
 #include "snes9x.h"
 #include "apu.h"
 #include "msu1.h"
@@ -206,6 +208,11 @@
 #define APU_DENOMINATOR_NTSC		328125
 #define APU_NUMERATOR_PAL			34176
 #define APU_DENOMINATOR_PAL			709379
+#define APU_JOB_SLOTS				4
+#define APU_JOB_EVENTS				1024
+#define APU_JOB_LINES				8
+#define APU_MAX_LAG_LINES			(APU_JOB_SLOTS * APU_JOB_LINES)
+#define APU_BUSY_WAIT_READS			2
 
 namespace SNES
 {
@@ -253,11 +260,51 @@ namespace msu
 	static uint8		*resample_buffer		= NULL;
 }
 
+/*  Threaded APU
+    The CPU side converts each port write and scanline end to an SMP clock
+    count and queues it, and a second thread runs the SMP/DSP through the
+    queue. Writes land on the same SMP cycle as when run inline, so only
+    port reads need the thread to catch up. The lag is bounded to
+    APU_MAX_LAG_LINES scanlines, about one APU_MINIMUM_SAMPLE_BLOCK of
+    output, after which the samples are landed on the CPU side as usual.
+*/
+
+enum
+{
+	APU_EVENT_SCANLINE = -1
+};
+
+struct SAPUEvent
+{
+	int32	clocks;
+	int8	port;
+	uint8	byte;
+};
+
+struct SAPUJob
+{
+	int		count;
+	struct SAPUEvent	events[APU_JOB_EVENTS];
+};
+
+namespace apu_thread
+{
+	static struct SAPUJob	jobs[APU_JOB_SLOTS];
+	static IG::Semaphore	freeSlots{APU_JOB_SLOTS}, pendingJobs{0}, threadExited{0};
+	static int			jobHead, jobTail;
+	static bool8		jobOpen, jobsInFlight, threadRunning, quitThread;
+
+	static int			queuedLines;
+	static int			portReads;
+	static bool8		inlineFallback;
+}
+
 static void EightBitize (uint8 *, int);
 static void DeStereo (uint8 *, int);
 static void ReverseStereo (uint8 *, int);
 static void UpdatePlaybackRate (void);
 static void SPCSnapshotCallback (void);
+static void SyncAPUThread (void);
 static inline int S9xAPUGetClock (int32);
 static inline int S9xAPUGetClockRemainder (int32);
 
@@ -462,6 +509,7 @@ bool8 S9xSyncSound (void)
 	if (!Settings.SoundSync || spc::sound_in_sync)
 		return (TRUE);
 
+	SyncAPUThread();
 	S9xLandSamples();
 
 	return (spc::sound_in_sync);
@@ -512,6 +560,8 @@ bool8 S9xInitSound (int buffer_ms, int lag_ms)
 	// buffer_ms : buffer size given in millisecond
 	// lag_ms    : allowable time-lag given in millisecond
 
+	SyncAPUThread();
+
 	int	sample_count     = buffer_ms * 32040 / 1000;
 	int	lag_sample_count = lag_ms    * 32040 / 1000;
 
@@ -578,6 +628,7 @@ bool8 S9xInitSound (int buffer_ms, int lag_ms)
 
 void S9xSetSoundControl (uint8 voice_switch)
 {
+	SyncAPUThread();
 	SNES::dsp.spc_dsp.set_stereo_switch (voice_switch << 8 | voice_switch);
 }
 
@@ -590,6 +641,7 @@ void S9xSetSoundMute (bool8 mute)
 
 void S9xDumpSPCSnapshot (void)
 {
+	SyncAPUThread();
 	SNES::dsp.spc_dsp.dump_spc_snapshot();
 
 }
@@ -612,6 +664,8 @@ bool8 S9xInitAPU (void)
 
 void S9xDeinitAPU (void)
 {
+	S9xDeinitThreadedAPU();
+
 	if (spc::resampler)
 	{
 		delete spc::resampler;
@@ -663,14 +717,173 @@ static inline int S9xAPUGetClockRemainder (int32 cpucycles)
 			spc::ratio_denominator;
 }
 
+static void APUThread (void)
+{
+	using namespace apu_thread;
+
+	for (;;)
+	{
+		pendingJobs.wait();
+		if (quitThread)
+		{
+			threadExited.notify();
+			return;
+		}
+
+		struct SAPUJob	&job = jobs[jobTail];
+		for (int i = 0; i < job.count; i++)
+		{
+			const struct SAPUEvent	&e = job.events[i];
+
+			SNES::smp.clock -= e.clocks;
+			SNES::smp.enter ();
+
+			if (e.port >= 0)
+				SNES::cpu.port_write (e.port, e.byte);
+			else
+			if (e.port == APU_EVENT_SCANLINE)
+				SNES::dsp.synchronize();
+		}
+
+		jobTail = (jobTail + 1) % APU_JOB_SLOTS;
+		freeSlots.notify();
+	}
+}
+
+static void SubmitAPUJob (void)
+{
+	using namespace apu_thread;
+
+	if (!jobOpen)
+		return;
+
+	jobHead = (jobHead + 1) % APU_JOB_SLOTS;
+	jobOpen = FALSE;
+	jobsInFlight = TRUE;
+	pendingJobs.notify();
+}
+
+static void SyncAPUThread (void)
+{
+	using namespace apu_thread;
+
+	SubmitAPUJob();
+	if (!jobsInFlight)
+		return;
+
+	for (int i = 0; i < APU_JOB_SLOTS; i++)
+		freeSlots.wait();
+	for (int i = 0; i < APU_JOB_SLOTS; i++)
+		freeSlots.notify();
+	jobsInFlight = FALSE;
+}
+
+static int32 S9xAPUAdvanceClock (void)
+{
+	int32	clocks = S9xAPUGetClock (CPU.Cycles);
+
+	spc::remainder = S9xAPUGetClockRemainder(CPU.Cycles);
+	spc::reference_time = CPU.Cycles;
+
+	return (clocks);
+}
+
+static void QueueAPUEvent (int port, uint8 byte)
+{
+	using namespace apu_thread;
+
+	if (jobOpen && jobs[jobHead].count == APU_JOB_EVENTS)
+		SubmitAPUJob();
+
+	if (!threadRunning)
+	{
+		IG::makeDetachedThread([](){ APUThread(); });
+		threadRunning = TRUE;
+	}
+
+	if (!jobOpen)
+	{
+		freeSlots.wait();
+		jobs[jobHead].count = 0;
+		jobOpen = TRUE;
+	}
+
+	struct SAPUEvent	&e = jobs[jobHead].events[jobs[jobHead].count++];
+	e.clocks = S9xAPUAdvanceClock();
+	e.port = port;
+	e.byte = byte;
+}
+
+static inline bool8 S9xAPUDecoupled (void)
+{
+	return (Settings.ThreadedAPU && !apu_thread::inlineFallback);
+}
+
+void S9xSetThreadedAPU (bool8 on)
+{
+	if (on)
+		SyncAPUThread();
+	else
+		S9xDeinitThreadedAPU();
+
+	Settings.ThreadedAPU = on;
+	apu_thread::queuedLines = 0;
+	apu_thread::portReads = 0;
+	apu_thread::inlineFallback = FALSE;
+}
+
+void S9xDeinitThreadedAPU (void)
+{
+	using namespace apu_thread;
+
+	SyncAPUThread();
+	if (!threadRunning)
+		return;
+
+	quitThread = TRUE;
+	pendingJobs.notify();
+	threadExited.wait();
+	quitThread = FALSE;
+	threadRunning = FALSE;
+}
+
+void S9xAPUEndFrame (void)
+{
+	// lands what the queued lines produced so the frame's samples are
+	// complete before the port mixes them
+	SyncAPUThread();
+	if (!apu_thread::queuedLines)
+		return;
+
+	apu_thread::queuedLines = 0;
+
+	if (SNES::dsp.spc_dsp.sample_count() >= APU_MINIMUM_SAMPLE_BLOCK || !spc::sound_in_sync)
+		S9xLandSamples();
+}
+
 uint8 S9xAPUReadPort (int port)
 {
+	if (Settings.ThreadedAPU)
+	{
+		// the SMP has to catch up before its ports can be read, a game polling
+		// them keeps the SMP inline until a scanline passes without a read
+		SyncAPUThread();
+		if (++apu_thread::portReads >= APU_BUSY_WAIT_READS)
+			apu_thread::inlineFallback = TRUE;
+	}
+
 	S9xAPUExecute ();
 	return ((uint8) SNES::smp.port_read (port & 3));
 }
 
 void S9xAPUWritePort (int port, uint8 byte)
 {
+	if (S9xAPUDecoupled())
+	{
+		QueueAPUEvent(port & 3, byte);
+		return;
+	}
+
 	S9xAPUExecute ();
 	SNES::cpu.port_write (port & 3, byte);
 }
@@ -692,6 +905,30 @@ void S9xAPUExecute (void)
 
 void S9xAPUEndScanline (void)
 {
+	if (Settings.ThreadedAPU)
+	{
+		bool8	polled = apu_thread::portReads != 0;
+		apu_thread::portReads = 0;
+
+		if (!apu_thread::inlineFallback)
+		{
+			QueueAPUEvent(APU_EVENT_SCANLINE, 0);
+			if (++apu_thread::queuedLines % APU_JOB_LINES == 0)
+				SubmitAPUJob();
+			if (apu_thread::queuedLines < APU_MAX_LAG_LINES)
+				return;
+
+			apu_thread::queuedLines = 0;
+			SyncAPUThread();
+
+			if (SNES::dsp.spc_dsp.sample_count() >= APU_MINIMUM_SAMPLE_BLOCK || !spc::sound_in_sync)
+				S9xLandSamples();
+			return;
+		}
+
+		apu_thread::inlineFallback = polled;
+	}
+
 	S9xAPUExecute();
 	SNES::dsp.synchronize();
 
@@ -715,6 +952,10 @@ void S9xAPUTimingSetSpeedup (int ticks)
 
 void S9xResetAPU (void)
 {
+	SyncAPUThread();
+	apu_thread::queuedLines = 0;
+	apu_thread::inlineFallback = FALSE;
+
 	spc::reference_time = 0;
 	spc::remainder = 0;
 
@@ -733,6 +974,10 @@ void S9xResetAPU (void)
 
 void S9xSoftResetAPU (void)
 {
+	SyncAPUThread();
+	apu_thread::queuedLines = 0;
+	apu_thread::inlineFallback = FALSE;
+
 	spc::reference_time = 0;
 	spc::remainder = 0;
 	SNES::cpu.reset ();
@@ -750,6 +995,8 @@ void S9xAPUSaveState (uint8 *block)
 {
 	uint8	*ptr = block;
 
+	SyncAPUThread();
+
 	SNES::smp.save_state (&ptr);
 	SNES::dsp.save_state (&ptr);
 
@@ -769,6 +1016,8 @@ void S9xAPULoadState (uint8 *block)
 {
 	uint8	*ptr = block;
 
+	SyncAPUThread();
+
 	SNES::smp.load_state (&ptr);
 	SNES::dsp.load_state (&ptr);
 
@@ -793,6 +1042,8 @@ void S9xAPULoadBlarggState(uint8 *oldblock)
 {
     uint8	*ptr = oldblock;
 
+    SyncAPUThread();
+
     SNES::SPC_State_Copier copier(&ptr,to_var_from_buf);
 
     copier.copy(SNES::smp.apuram,0x10000); // RAM
@@ -211,6 +211,9 @@ void S9xAPUEndScanline (void);
 void S9xAPUSetReferenceTime (int32);
 void S9xAPUTimingSetSpeedup (int);
 void S9xAPUAllowTimeOverflow (bool);
+void S9xSetThreadedAPU (bool8);
+void S9xDeinitThreadedAPU (void);
+void S9xAPUEndFrame (void);
 void S9xAPULoadState (uint8 *);
 void S9xAPULoadBlarggState(uint8 *oldblock);
 void S9xAPUSaveState (uint8 *);
@@ -4,15 +4,15 @@
 #define SNES_NTSC_CONFIG_H
 
 /* Format of source pixels */
-#define SNES_NTSC_IN_FORMAT SNES_NTSC_RGB15
-/* #define SNES_NTSC_IN_FORMAT SNES_NTSC_RGB16 */
+/* #define SNES_NTSC_IN_FORMAT SNES_NTSC_RGB15 */
+#define SNES_NTSC_IN_FORMAT SNES_NTSC_RGB16
 /* #define SNES_NTSC_IN_FORMAT SNES_NTSC_BGR15 */
 
 /* The following affect the built-in blitter only; a custom blitter can
 handle things however it wants. */
 
 /* Bits per pixel of output. Can be 15, 16, 32, or 24 (same as 32). */
-#define SNES_NTSC_OUT_DEPTH 15
+#define SNES_NTSC_OUT_DEPTH 16
 
 /* Type of input pixel values */
 #define SNES_NTSC_IN_T unsigned short
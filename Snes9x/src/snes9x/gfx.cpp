@@ -193,6 +193,8 @@
 #include "snes9x.h"
 #include "ppu.h"
 #include "tile.h"
+#include "gfxthread.h"
+#ifndef GFX_RENDER_THREAD
 #include "controls.h"
 #include "crosshairs.h"
 #include "cheats.h"
@@ -202,17 +204,21 @@
 #include "display.h"
 
 extern struct SCheatData		Cheat;
+#endif
 
 void S9xComputeClipWindows (void);
 
+#ifndef GFX_RENDER_THREAD
 static int	font_width = 8, font_height = 9;
 
-static void SetupOBJ (void);
-static void DrawOBJS (int);
 static void DisplayFrameRate (void);
 static void DisplayPressedKeys (void);
 static void DisplayWatchedAddresses (void);
 static void DisplayStringFromBottom (const char *, int, int, bool);
+static uint16 get_crosshair_color (uint8);
+#endif
+static void SetupOBJ (void);
+static void DrawOBJS (int);
 static void DrawBackground (int, uint8, uint8);
 static void DrawBackgroundMosaic (int, uint8, uint8);
 static void DrawBackgroundOffset (int, uint8, uint8, int);
@@ -220,10 +226,10 @@ static void DrawBackgroundOffsetMosaic (int, uint8, uint8, int);
 static inline void DrawBackgroundMode7 (int, void (*DrawMath) (uint32, uint32, int), void (*DrawNomath) (uint32, uint32, int), int);
 static inline void DrawBackdrop (void);
 static inline void RenderScreen (bool8);
-static uint16 get_crosshair_color (uint8);
 
 #define TILE_PLUS(t, x)	(((t) & 0xfc00) | ((t + x) & 0x3ff))
 
+#ifndef GFX_RENDER_THREAD
 
 bool8 S9xGraphicsInit (void)
 {
@@ -325,6 +331,7 @@ void S9xGraphicsDeinit (void)
 	if (GFX.ZBuffer)    { free(GFX.ZBuffer);    GFX.ZBuffer    = NULL; }
 	if (GFX.SubZBuffer) { free(GFX.SubZBuffer); GFX.SubZBuffer = NULL; }
 }
+#endif
 
 void S9xBuildDirectColourMaps (void)
 {
@@ -337,6 +344,8 @@ void S9xBuildDirectColourMaps (void)
 	IPPU.DirectColourMapsNeedRebuild = FALSE;
 }
 
+#ifndef GFX_RENDER_THREAD
+
 void S9xStartScreenRefresh (void)
 {
 	GFX.InterlaceFrame = !GFX.InterlaceFrame;
@@ -399,8 +408,13 @@ void S9xStartScreenRefresh (void)
 		PPU.RecomputeClipWindows = TRUE;
 		IPPU.PreviousLine = IPPU.CurrentLine = 0;
 
-		memset(GFX.ZBuffer, 0, GFX.ScreenSize);
-		memset(GFX.SubZBuffer, 0, GFX.ScreenSize);
+		if (Settings.ThreadedRendering)
+			S9xThreadedStartScreenRefresh();
+		else
+		{
+			memset(GFX.ZBuffer, 0, GFX.ScreenSize);
+			memset(GFX.SubZBuffer, 0, GFX.ScreenSize);
+		}
 	}
 
 	if (++IPPU.FrameCount % Memory.ROMFramesPerSecond == 0)
@@ -421,6 +435,7 @@ void S9xEndScreenRefresh (void)
 	if (IPPU.RenderThisFrame)
 	{
 		FLUSH_REDRAW();
+		S9xSyncRenderThread();
 
 		if (GFX.DoInterlace && GFX.InterlaceFrame == 0)
 		{
@@ -519,6 +534,9 @@ void RenderLine (uint8 C)
 		}
 
 		IPPU.CurrentLine = C + 1;
+
+		if (Settings.ThreadedRendering)
+			S9xThreadedRenderLine(C);
 	}
 	else
 	{
@@ -529,6 +547,7 @@ void RenderLine (uint8 C)
 		PPU.RangeTimeOver |= GFX.OBJLines[C].RTOFlags;
 	}
 }
+#endif
 
 static inline void RenderScreen (bool8 sub)
 {
@@ -670,6 +689,16 @@ void S9xUpdateScreen (void)
 	if ((GFX.EndY = IPPU.CurrentLine - 1) >= PPU.ScreenHeight)
 		GFX.EndY = PPU.ScreenHeight - 1;
 
+#ifndef GFX_RENDER_THREAD
+	if (Settings.ThreadedRendering)
+	{
+		// drawn by S9xRenderUpdateScreen() on the render thread
+		S9xThreadedUpdateScreen();
+		IPPU.PreviousLine = IPPU.CurrentLine;
+		return;
+	}
+#endif
+
 	if (!PPU.ForcedBlanking)
 	{
 		// If force blank, may as well completely skip all this. We only did
@@ -1953,6 +1982,7 @@ static inline void DrawBackdrop (void)
 	}
 }
 
+#ifndef GFX_RENDER_THREAD
 void S9xReRefresh (void)
 {
 	// Be careful when calling this function from the thread other than the emulation one...
@@ -2413,3 +2443,5 @@ bool8 S9xSetRenderPixelFormat (int format)
 }
 
 #endif
+
+#endif
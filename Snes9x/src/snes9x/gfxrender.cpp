@@ -0,0 +1,28 @@
+/*  Threaded PPU renderer
+    Builds the render thread's copy of the tile, clip and screen drawing code
+    by redirecting the globals it uses to the S9xRender* set in gfxthread.cpp.
+*/
+
+#include "snes9x.h"
+#include "memmap.h"
+#include "ppu.h"
+#include "tile.h"
+#include "gfxthread.h"
+
+#define GFX_RENDER_THREAD
+
+#define PPU								S9xRenderPPU
+#define IPPU							S9xRenderIPPU
+#define GFX								S9xRenderGFX
+#define Memory							S9xRenderMemory
+#define DirectColourMaps				S9xRenderDirectColourMaps
+#define S9xUpdateScreen					S9xRenderUpdateScreen
+#define S9xBuildDirectColourMaps		S9xRenderBuildDirectColourMaps
+#define S9xComputeClipWindows			S9xRenderComputeClipWindows
+#define S9xInitTileRenderer				S9xRenderInitTileRenderer
+#define S9xSelectTileRenderers			S9xRenderSelectTileRenderers
+#define S9xSelectTileConverter			S9xRenderSelectTileConverter
+
+#include "gfx.cpp"
+#include "clip.cpp"
+#include "tile.cpp"
@@ -0,0 +1,456 @@
+/*  Threaded PPU renderer
+    S9xUpdateScreen() and RenderLine() queue line ranges along with a copy of
+    the PPU state that the renderer reads. Ranges are also queued eagerly every
+    RENDER_BAND_LINES lines so drawing overlaps the CPU; an eager range is
+    drawn again at the next flush if any of that state changed in between, so
+    the output matches the serial renderer.
+*/
+
+#include <imagine/thread/Thread.hh>
+#include <imagine/thread/Semaphore.hh>
+#include "snes9x.h"
+#include "memmap.h"
+#include "ppu.h"
+#include "tile.h"
+#include "gfxthread.h"
+
+#define RENDER_JOB_SLOTS	4
+#define RENDER_BAND_LINES	16
+
+struct SPPU				S9xRenderPPU;
+struct InternalPPU		S9xRenderIPPU;
+struct SGFX				S9xRenderGFX;
+struct SRenderMemory	S9xRenderMemory;
+uint16					S9xRenderDirectColourMaps[8][256];
+uint64					S9xVRAMDirtyBlocks = ~(uint64) 0;
+
+// everything the renderer reads besides VRAM and the latched line data
+struct SRenderState
+{
+	struct SPPU	PPU;
+	uint16	ScreenColors[256];
+	const uint8	*XB;
+	uint8	FillRAM[0x40];
+	bool8	Interlace;
+	bool8	InterlaceOBJ;
+	bool8	PseudoHires;
+};
+
+struct SRenderFrame
+{
+	uint16	*Screen;
+	uint32	RealPPL;
+	uint32	PPL;
+	uint8	DoInterlace;
+	uint8	InterlaceFrame;
+	bool8	DoubleWidthPixels;
+	bool8	DoubleHeightPixels;
+	int		RenderedScreenWidth;
+	int		RenderedScreenHeight;
+};
+
+struct SRenderJob
+{
+	struct SRenderState	State;
+	bool8	RecomputeClipWindows;
+	bool8	StartFrame;
+	bool8	PushFrame;
+	bool8	Redraw;
+	int		StartLine;
+	int		EndLine;
+	int		LineDataStart;
+	struct SRenderFrame	Frame;
+	SLineData		LineData[240];
+	SLineMatrixData	LineMatrixData[240];
+	uint64	VRAMBlocks;
+	uint8	VRAM[0x10000];
+};
+
+static struct SRenderJob	jobs[RENDER_JOB_SLOTS];
+static IG::Semaphore	freeSlots{RENDER_JOB_SLOTS}, pendingJobs{0}, threadExited{0};
+static int	jobHead, jobTail, jobsInFlight;
+static bool8	threadRunning, quitThread;
+
+// emulation thread state
+static struct SRenderState	stateBuffers[2];
+static struct SRenderState	*sentState = &stateBuffers[0], *nextState = &stateBuffers[1];
+static int	eagerLine, lineDataSent;
+static bool8	startFrame, pushFrame, renderOwnsFrame;
+
+// render thread state
+static uint8	renderVRAM[0x10000];
+static uint8	renderFillRAM[0x2140];
+
+static void RenderJob (struct SRenderJob &);
+
+static void RenderThread (void)
+{
+	for (;;)
+	{
+		pendingJobs.wait();
+		if (quitThread)
+		{
+			threadExited.notify();
+			return;
+		}
+		RenderJob(jobs[jobTail]);
+		jobTail = (jobTail + 1) % RENDER_JOB_SLOTS;
+		freeSlots.notify();
+	}
+}
+
+static void FreeRenderBuffers (void)
+{
+	free(S9xRenderGFX.SubScreen);
+	free(S9xRenderGFX.ZBuffer);
+	free(S9xRenderGFX.SubZBuffer);
+	S9xRenderGFX.SubScreen = NULL;
+	S9xRenderGFX.ZBuffer = S9xRenderGFX.SubZBuffer = NULL;
+	for (int t = 0; t < 7; t++)
+	{
+		free(S9xRenderIPPU.TileCache[t]);
+		free(S9xRenderIPPU.TileCached[t]);
+		S9xRenderIPPU.TileCache[t] = S9xRenderIPPU.TileCached[t] = NULL;
+	}
+}
+
+static bool8 InitRenderThread (void)
+{
+	if (threadRunning)
+		return (TRUE);
+
+	// share the colour math tables and pixel format, but not the buffers
+	memcpy(&S9xRenderGFX, &GFX, sizeof(struct SGFX));
+	S9xRenderGFX.SubScreen  = (uint16 *) malloc(GFX.ScreenSize * sizeof(uint16));
+	S9xRenderGFX.ZBuffer    = (uint8 *)  malloc(GFX.ScreenSize);
+	S9xRenderGFX.SubZBuffer = (uint8 *)  malloc(GFX.ScreenSize);
+
+	S9xRenderIPPU.TileCache[TILE_2BIT]       = (uint8 *) malloc(MAX_2BIT_TILES * 64);
+	S9xRenderIPPU.TileCache[TILE_4BIT]       = (uint8 *) malloc(MAX_4BIT_TILES * 64);
+	S9xRenderIPPU.TileCache[TILE_8BIT]       = (uint8 *) malloc(MAX_8BIT_TILES * 64);
+	S9xRenderIPPU.TileCache[TILE_2BIT_EVEN]  = (uint8 *) malloc(MAX_2BIT_TILES * 64);
+	S9xRenderIPPU.TileCache[TILE_2BIT_ODD]   = (uint8 *) malloc(MAX_2BIT_TILES * 64);
+	S9xRenderIPPU.TileCache[TILE_4BIT_EVEN]  = (uint8 *) malloc(MAX_4BIT_TILES * 64);
+	S9xRenderIPPU.TileCache[TILE_4BIT_ODD]   = (uint8 *) malloc(MAX_4BIT_TILES * 64);
+
+	S9xRenderIPPU.TileCached[TILE_2BIT]      = (uint8 *) calloc(MAX_2BIT_TILES, 1);
+	S9xRenderIPPU.TileCached[TILE_4BIT]      = (uint8 *) calloc(MAX_4BIT_TILES, 1);
+	S9xRenderIPPU.TileCached[TILE_8BIT]      = (uint8 *) calloc(MAX_8BIT_TILES, 1);
+	S9xRenderIPPU.TileCached[TILE_2BIT_EVEN] = (uint8 *) calloc(MAX_2BIT_TILES, 1);
+	S9xRenderIPPU.TileCached[TILE_2BIT_ODD]  = (uint8 *) calloc(MAX_2BIT_TILES, 1);
+	S9xRenderIPPU.TileCached[TILE_4BIT_EVEN] = (uint8 *) calloc(MAX_4BIT_TILES, 1);
+	S9xRenderIPPU.TileCached[TILE_4BIT_ODD]  = (uint8 *) calloc(MAX_4BIT_TILES, 1);
+
+	bool8	ok = S9xRenderGFX.SubScreen && S9xRenderGFX.ZBuffer && S9xRenderGFX.SubZBuffer;
+	for (int t = 0; t < 7; t++)
+		ok = ok && S9xRenderIPPU.TileCache[t] && S9xRenderIPPU.TileCached[t];
+
+	if (!ok)
+	{
+		FreeRenderBuffers();
+		return (FALSE);
+	}
+
+	S9xRenderMemory.VRAM = renderVRAM;
+	S9xRenderMemory.FillRAM = renderFillRAM;
+	S9xRenderIPPU.DirectColourMapsNeedRebuild = TRUE;
+	S9xRenderIPPU.OBJChanged = TRUE;
+	S9xRenderInitTileRenderer();
+
+	IG::makeDetachedThread([](){ RenderThread(); });
+	threadRunning = TRUE;
+	return (TRUE);
+}
+
+void S9xSetThreadedRendering (bool8 on)
+{
+	S9xSyncRenderThread();
+	if (on && !Settings.ThreadedRendering)
+		S9xVRAMDirtyBlocks = ~(uint64) 0; // render thread's copy may be stale
+	Settings.ThreadedRendering = on;
+}
+
+void S9xDeinitThreadedRendering (void)
+{
+	if (!threadRunning)
+		return;
+
+	S9xSyncRenderThread();
+	quitThread = TRUE;
+	pendingJobs.notify();
+	threadExited.wait();
+	quitThread = FALSE;
+	threadRunning = FALSE;
+
+	FreeRenderBuffers();
+	jobHead = jobTail = 0;
+	S9xVRAMDirtyBlocks = ~(uint64) 0; // render thread's copy is dropped with it
+}
+
+// Fields the renderer never reads are cleared so they don't cause redraws
+
+static void NormalizePPU (struct SPPU &p)
+{
+	memset(&p.VMA, 0, sizeof(p.VMA));
+	p.WRAM = 0;
+	for (int i = 0; i < 4; i++)
+		p.BG[i].HOffset = p.BG[i].VOffset = 0; // latched per line
+	p.CGFLIP = p.CGFLIPRead = p.CGADD = 0;
+	memset(p.CGDATA, 0, sizeof(p.CGDATA)); // IPPU.ScreenColors is compared instead
+	p.OAMAddr &= 1;
+	p.SavedOAMAddr = p.OAMReadFlip = p.OAMTileAddress = p.OAMWriteRegister = 0;
+	memset(p.OAMData, 0, sizeof(p.OAMData)); // PPU.OBJ is compared instead
+	p.LastSprite = p.RangeTimeOver = 0;
+	p.HTimerEnabled = p.VTimerEnabled = FALSE;
+	p.HTimerPosition = p.VTimerPosition = 0;
+	p.IRQHBeamPos = p.IRQVBeamPos = 0;
+	p.HBeamFlip = p.VBeamFlip = 0;
+	p.HBeamPosLatched = p.VBeamPosLatched = p.GunHLatch = p.GunVLatch = 0;
+	p.HVBeamCounterLatched = 0;
+	p.MatrixA = p.MatrixB = p.MatrixC = p.MatrixD = 0; // latched per line
+	p.CentreX = p.CentreY = p.M7HOFS = p.M7VOFS = 0;
+	p.RecomputeClipWindows = FALSE;
+	p.Need16x8Mulitply = FALSE;
+	p.BGnxOFSbyte = p.M7byte = 0;
+	p.HDMA = p.HDMAEnded = 0;
+	p.OpenBus1 = p.OpenBus2 = 0;
+}
+
+static void BuildRenderState (struct SRenderState &s)
+{
+	memcpy(&s.PPU, &PPU, sizeof(struct SPPU));
+	NormalizePPU(s.PPU);
+	memcpy(s.ScreenColors, IPPU.ScreenColors, sizeof(s.ScreenColors));
+	s.XB = IPPU.XB;
+	memset(s.FillRAM, 0, sizeof(s.FillRAM));
+	memcpy(s.FillRAM + 0x2c, Memory.FillRAM + 0x212c, 0x2134 - 0x212c);
+	s.Interlace = IPPU.Interlace;
+	s.InterlaceOBJ = IPPU.InterlaceOBJ;
+	s.PseudoHires = IPPU.PseudoHires;
+}
+
+static bool8 OBJStateEqual (const struct SPPU &a, const struct SPPU &b)
+{
+	return (!memcmp(a.OBJ, b.OBJ, sizeof(a.OBJ)) &&
+		a.OBJSizeSelect == b.OBJSizeSelect &&
+		a.FirstSprite == b.FirstSprite &&
+		a.OAMPriorityRotation == b.OAMPriorityRotation &&
+		a.OAMFlip == b.OAMFlip &&
+		a.OAMAddr == b.OAMAddr);
+}
+
+static void QueueLines (void)
+{
+	BuildRenderState(*nextState);
+
+	int		start = eagerLine > IPPU.PreviousLine ? eagerLine : IPPU.PreviousLine;
+	bool8	redraw = FALSE;
+	if (eagerLine > IPPU.PreviousLine &&
+		(S9xVRAMDirtyBlocks || memcmp(nextState, sentState, sizeof(struct SRenderState))))
+	{
+		// lines drawn eagerly since the last flush used stale state
+		start = IPPU.PreviousLine;
+		redraw = TRUE;
+	}
+
+	if (start >= IPPU.CurrentLine)
+		return;
+
+	freeSlots.wait();
+	struct SRenderJob	&job = jobs[jobHead];
+
+	memcpy(&job.State, nextState, sizeof(struct SRenderState));
+	job.RecomputeClipWindows = PPU.RecomputeClipWindows || redraw;
+	job.Redraw = redraw;
+	job.StartLine = start;
+	job.EndLine = IPPU.CurrentLine;
+
+	job.LineDataStart = lineDataSent;
+	for (int l = lineDataSent; l < IPPU.CurrentLine && l < 240; l++)
+	{
+		job.LineData[l] = GFX.LineData[l];
+		job.LineMatrixData[l] = GFX.LineMatrixData[l];
+	}
+	lineDataSent = IPPU.CurrentLine;
+
+	job.StartFrame = startFrame;
+	job.PushFrame = pushFrame;
+	if (pushFrame)
+	{
+		job.Frame.Screen = GFX.Screen;
+		job.Frame.RealPPL = GFX.RealPPL;
+		job.Frame.PPL = GFX.PPL;
+		job.Frame.DoInterlace = GFX.DoInterlace;
+		job.Frame.InterlaceFrame = GFX.InterlaceFrame;
+		job.Frame.DoubleWidthPixels = IPPU.DoubleWidthPixels;
+		job.Frame.DoubleHeightPixels = IPPU.DoubleHeightPixels;
+		job.Frame.RenderedScreenWidth = IPPU.RenderedScreenWidth;
+		job.Frame.RenderedScreenHeight = IPPU.RenderedScreenHeight;
+		renderOwnsFrame = TRUE;
+	}
+	startFrame = pushFrame = FALSE;
+
+	job.VRAMBlocks = S9xVRAMDirtyBlocks;
+	for (uint64 blocks = S9xVRAMDirtyBlocks; blocks; blocks &= blocks - 1)
+	{
+		uint32	offset = __builtin_ctzll(blocks) << VRAM_BLOCK_SHIFT;
+		memcpy(job.VRAM + offset, Memory.VRAM + offset, 1 << VRAM_BLOCK_SHIFT);
+	}
+	S9xVRAMDirtyBlocks = 0;
+
+	jobHead = (jobHead + 1) % RENDER_JOB_SLOTS;
+	jobsInFlight++;
+	pendingJobs.notify();
+
+	struct SRenderState	*s = sentState;
+	sentState = nextState;
+	nextState = s;
+	eagerLine = IPPU.CurrentLine;
+}
+
+void S9xThreadedStartScreenRefresh (void)
+{
+	if (!InitRenderThread())
+	{
+		Settings.ThreadedRendering = FALSE;
+		memset(GFX.ZBuffer, 0, GFX.ScreenSize);
+		memset(GFX.SubZBuffer, 0, GFX.ScreenSize);
+		return;
+	}
+
+	startFrame = pushFrame = TRUE;
+	eagerLine = lineDataSent = 0;
+}
+
+void S9xThreadedUpdateScreen (void)
+{
+	QueueLines();
+	if (!PPU.ForcedBlanking)
+		PPU.RecomputeClipWindows = FALSE;
+}
+
+void S9xThreadedRenderLine (uint8 C)
+{
+	int	start = eagerLine > IPPU.PreviousLine ? eagerLine : IPPU.PreviousLine;
+	if (C + 1 - start >= RENDER_BAND_LINES)
+		QueueLines();
+}
+
+void S9xThreadedFrameChanged (void)
+{
+	pushFrame = TRUE;
+}
+
+void S9xSyncRenderThread (void)
+{
+	if (!jobsInFlight)
+		return;
+
+	for (int i = 0; i < RENDER_JOB_SLOTS; i++)
+		freeSlots.wait();
+	for (int i = 0; i < RENDER_JOB_SLOTS; i++)
+		freeSlots.notify();
+	jobsInFlight = 0;
+
+	if (renderOwnsFrame)
+	{
+		// take back any hi-res/interlace switch made while drawing
+		GFX.RealPPL = S9xRenderGFX.RealPPL;
+		GFX.PPL = S9xRenderGFX.PPL;
+		GFX.DoInterlace = S9xRenderGFX.DoInterlace;
+		IPPU.DoubleWidthPixels = S9xRenderIPPU.DoubleWidthPixels;
+		IPPU.DoubleHeightPixels = S9xRenderIPPU.DoubleHeightPixels;
+		IPPU.RenderedScreenWidth = S9xRenderIPPU.RenderedScreenWidth;
+		IPPU.RenderedScreenHeight = S9xRenderIPPU.RenderedScreenHeight;
+		renderOwnsFrame = FALSE;
+	}
+}
+
+// Render thread side
+
+static void InvalidateTiles (uint32 offset)
+{
+	const uint32	blockSize = 1 << VRAM_BLOCK_SHIFT;
+	uint8	**cached = S9xRenderIPPU.TileCached;
+
+	memset(cached[TILE_2BIT] + (offset >> 4), 0, blockSize >> 4);
+	memset(cached[TILE_4BIT] + (offset >> 5), 0, blockSize >> 5);
+	memset(cached[TILE_8BIT] + (offset >> 6), 0, blockSize >> 6);
+
+	// interlaced tiles also read the following tile
+	for (int t = TILE_2BIT_EVEN; t <= TILE_2BIT_ODD; t++)
+	{
+		memset(cached[t] + (offset >> 4), 0, blockSize >> 4);
+		cached[t][((offset >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
+	}
+
+	for (int t = TILE_4BIT_EVEN; t <= TILE_4BIT_ODD; t++)
+	{
+		memset(cached[t] + (offset >> 5), 0, blockSize >> 5);
+		cached[t][((offset >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	}
+}
+
+static void RenderJob (struct SRenderJob &job)
+{
+	for (uint64 blocks = job.VRAMBlocks; blocks; blocks &= blocks - 1)
+	{
+		uint32	offset = __builtin_ctzll(blocks) << VRAM_BLOCK_SHIFT;
+		memcpy(renderVRAM + offset, job.VRAM + offset, 1 << VRAM_BLOCK_SHIFT);
+		InvalidateTiles(offset);
+	}
+
+	for (int l = job.LineDataStart; l < job.EndLine && l < 240; l++)
+	{
+		S9xRenderGFX.LineData[l] = job.LineData[l];
+		S9xRenderGFX.LineMatrixData[l] = job.LineMatrixData[l];
+	}
+
+	if (job.PushFrame)
+	{
+		S9xRenderGFX.Screen = job.Frame.Screen;
+		S9xRenderGFX.RealPPL = job.Frame.RealPPL;
+		S9xRenderGFX.PPL = job.Frame.PPL;
+		S9xRenderGFX.DoInterlace = job.Frame.DoInterlace;
+		S9xRenderGFX.InterlaceFrame = job.Frame.InterlaceFrame;
+		S9xRenderIPPU.DoubleWidthPixels = job.Frame.DoubleWidthPixels;
+		S9xRenderIPPU.DoubleHeightPixels = job.Frame.DoubleHeightPixels;
+		S9xRenderIPPU.RenderedScreenWidth = job.Frame.RenderedScreenWidth;
+		S9xRenderIPPU.RenderedScreenHeight = job.Frame.RenderedScreenHeight;
+	}
+
+	if (job.StartFrame)
+	{
+		memset(S9xRenderGFX.ZBuffer, 0, GFX.ScreenSize);
+		memset(S9xRenderGFX.SubZBuffer, 0, GFX.ScreenSize);
+		S9xRenderIPPU.OBJChanged = TRUE;
+	}
+	else
+	if (job.Redraw)
+	{
+		uint32	offset = job.StartLine * S9xRenderGFX.PPL;
+		uint32	size = (job.EndLine - job.StartLine) * S9xRenderGFX.PPL;
+		if (offset + size > GFX.ScreenSize)
+			size = GFX.ScreenSize - offset;
+		memset(S9xRenderGFX.ZBuffer + offset, 0, size);
+		memset(S9xRenderGFX.SubZBuffer + offset, 0, size);
+	}
+
+	if (!OBJStateEqual(S9xRenderPPU, job.State.PPU) || job.State.InterlaceOBJ != S9xRenderIPPU.InterlaceOBJ)
+		S9xRenderIPPU.OBJChanged = TRUE;
+	if (job.State.XB != S9xRenderIPPU.XB)
+		S9xRenderIPPU.DirectColourMapsNeedRebuild = TRUE;
+
+	memcpy(&S9xRenderPPU, &job.State.PPU, sizeof(struct SPPU));
+	S9xRenderPPU.RecomputeClipWindows = job.RecomputeClipWindows;
+	memcpy(S9xRenderIPPU.ScreenColors, job.State.ScreenColors, sizeof(S9xRenderIPPU.ScreenColors));
+	S9xRenderIPPU.XB = job.State.XB;
+	memcpy(renderFillRAM + 0x2100, job.State.FillRAM, sizeof(job.State.FillRAM));
+	S9xRenderIPPU.Interlace = job.State.Interlace;
+	S9xRenderIPPU.InterlaceOBJ = job.State.InterlaceOBJ;
+	S9xRenderIPPU.PseudoHires = job.State.PseudoHires;
+
+	S9xRenderIPPU.PreviousLine = job.StartLine;
+	S9xRenderIPPU.CurrentLine = job.EndLine;
+	S9xRenderUpdateScreen();
+}
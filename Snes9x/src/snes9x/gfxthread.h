@@ -0,0 +1,45 @@
+#ifndef _GFXTHREAD_H_
+#define _GFXTHREAD_H_
+
+/*  Threaded PPU renderer
+    The emulation thread snapshots the PPU state that affects each line range
+    and queues it, while a second copy of gfx.cpp/tile.cpp/clip.cpp (built
+    against the S9xRender* globals below) draws the ranges behind it.
+*/
+
+#include "snes9x.h"
+#include "ppu.h"
+
+struct SRenderMemory
+{
+	uint8	*VRAM;
+	uint8	*FillRAM;
+};
+
+// render thread copies of the globals used by gfx.cpp/tile.cpp/clip.cpp,
+// BG is only scratch state and stays shared as one renderer runs at a time
+extern struct SPPU			S9xRenderPPU;
+extern struct InternalPPU	S9xRenderIPPU;
+extern struct SGFX			S9xRenderGFX;
+extern struct SRenderMemory	S9xRenderMemory;
+extern uint16				S9xRenderDirectColourMaps[8][256];
+
+// render thread copies of the gfx.cpp/tile.cpp/clip.cpp entry points
+void S9xRenderUpdateScreen (void);
+void S9xRenderBuildDirectColourMaps (void);
+void S9xRenderComputeClipWindows (void);
+void S9xRenderInitTileRenderer (void);
+void S9xRenderSelectTileRenderers (int, bool8, bool8);
+void S9xRenderSelectTileConverter (int, bool8, bool8, bool8);
+
+// called from the emulation thread
+void S9xSetThreadedRendering (bool8);
+void S9xDeinitThreadedRendering (void);
+void S9xThreadedStartScreenRefresh (void);
+void S9xThreadedUpdateScreen (void);
+void S9xThreadedRenderLine (uint8);
+void S9xThreadedFrameChanged (void);
+void S9xSyncRenderThread (void);
+void S9xInvalidateRenderVRAM (void);
+
+#endif
@@ -200,6 +200,7 @@
 #include "controls.h"
 #include "movie.h"
 #include "display.h"
+#include "gfxthread.h"
 #ifdef NETPLAY_SUPPORT
 #include "netplay.h"
 #endif
@@ -978,10 +979,13 @@ void S9xSetPPU (uint8 Byte, uint16 Address)
 					if (Byte & 0x04)
 					{
 						PPU.ScreenHeight = SNES_HEIGHT_EXTENDED;
+						S9xSyncRenderThread(); // may have switched to double height
 						if (IPPU.DoubleHeightPixels)
 							IPPU.RenderedScreenHeight = PPU.ScreenHeight << 1;
 						else
 							IPPU.RenderedScreenHeight = PPU.ScreenHeight;
+						if (Settings.ThreadedRendering)
+							S9xThreadedFrameChanged();
 					#ifdef DEBUGGER
 						missing.lines_239 = 1;
 					#endif
@@ -1981,6 +1985,7 @@ void S9xSoftResetPPU (void)
 	memset(IPPU.TileCached[TILE_2BIT_ODD], 0,  MAX_2BIT_TILES);
 	memset(IPPU.TileCached[TILE_4BIT_EVEN], 0, MAX_4BIT_TILES);
 	memset(IPPU.TileCached[TILE_4BIT_ODD], 0,  MAX_4BIT_TILES);
+	S9xVRAMDirtyBlocks = ~(uint64) 0;
 	IPPU.VRAMReadBuffer = 0; // XXX: FIXME: anything better?
 	GFX.InterlaceFrame = 0;
 	IPPU.Interlace = FALSE;
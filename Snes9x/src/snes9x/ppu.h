@@ -207,6 +207,9 @@
 #define MAX_4BIT_TILES		2048
 #define MAX_8BIT_TILES		1024
 
+// VRAM is shadowed by the threaded renderer in 1KB blocks
+#define VRAM_BLOCK_SHIFT	10
+
 #define CLIP_OR				0
 #define CLIP_AND			1
 #define CLIP_XOR			2
@@ -387,6 +390,7 @@ static const uint16 SignExtend[2]
 };
 extern struct SPPU			PPU;
 extern struct InternalPPU	IPPU;
+extern uint64				S9xVRAMDirtyBlocks;
 
 void S9xResetPPU (void);
 void S9xSoftResetPPU (void);
@@ -556,6 +560,7 @@ static inline void REGISTER_2118 (uint8 Byte)
 	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xVRAMDirtyBlocks |= (uint64) 1 << (address >> VRAM_BLOCK_SHIFT);
 
 	if (!PPU.VMA.High)
 	{
@@ -593,6 +598,7 @@ static inline void REGISTER_2119 (uint8 Byte)
 	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xVRAMDirtyBlocks |= (uint64) 1 << (address >> VRAM_BLOCK_SHIFT);
 
 	if (PPU.VMA.High)
 	{
@@ -624,6 +630,7 @@ static inline void REGISTER_2118_tile (uint8 Byte)
 	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xVRAMDirtyBlocks |= (uint64) 1 << (address >> VRAM_BLOCK_SHIFT);
 
 	if (!PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -649,6 +656,7 @@ static inline void REGISTER_2119_tile (uint8 Byte)
 	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xVRAMDirtyBlocks |= (uint64) 1 << (address >> VRAM_BLOCK_SHIFT);
 
 	if (PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -673,6 +681,7 @@ static inline void REGISTER_2118_linear (uint8 Byte)
 	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xVRAMDirtyBlocks |= (uint64) 1 << (address >> VRAM_BLOCK_SHIFT);
 
 	if (!PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
@@ -697,6 +706,7 @@ static inline void REGISTER_2119_linear (uint8 Byte)
 	IPPU.TileCached[TILE_4BIT_EVEN][((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [address >> 5] = FALSE;
 	IPPU.TileCached[TILE_4BIT_ODD] [((address >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	S9xVRAMDirtyBlocks |= (uint64) 1 << (address >> VRAM_BLOCK_SHIFT);
 
 	if (PPU.VMA.High)
 		PPU.VMA.Address += PPU.VMA.Increment;
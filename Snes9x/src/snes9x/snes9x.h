@@ -419,6 +419,8 @@ struct SSettings
 	static const bool8	SupportHiRes = 1;
 	static const bool8	Transparency = 1;
 	uint8	BG_Forced = 0;
+	bool8	ThreadedRendering = 0;
+	bool8	ThreadedAPU = 0;
 	static const bool8	DisableGraphicWindows = 0;
 
 	static const bool8	DisplayFrameRate = 0;